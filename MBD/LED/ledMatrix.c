@@ -6,6 +6,7 @@
 #include "ledMatrix.h"
 #include "lumissil.h"
 #include "ledMapRGB.h"
+#include "lxI2CShadow.h"
 
 
 /***/
@@ -186,20 +187,26 @@ int ledMatHack (const LXI2CBusCtx *pC, const U8 busAddr, const U8 modeFlags)
    int r;
    FramePage   frames[8];
    ControlPage cp;
+   LXI2CShadow sh;
    U8 i, n, t, pageSel[2]={LMSL_REG_PAGE_SEL,LMSL_CTRL_PAGE};
 
    tstH(8);
 
-   r= lxi2cReadRB(pC, busAddr, pageSel, sizeof(pageSel));
+   // Shadow all pages (frames & control) so that unchanged registers are not rewritten
+   r= lxi2cShadowInit(&sh, pC, busAddr, sizeof(FramePage)-1, 1, LMSL_CTRL_PAGE+1, LMSL_REG_PAGE_SEL, LX_SHADOW_AUTOINC|LX_SHADOW_PAGED);
+   if (r < 0) { return(r); }
+   lxi2cShadowVolatile(&sh, LMSL_CTRL_PAGE, LMSL_REG_FRAMESTAT, 1);
+
+   r= lxi2cShadowReadRB(&sh, pageSel, sizeof(pageSel));
    if (LMSL_CTRL_PAGE != pageSel[1])
    {
       printf("got page %x\n", pageSel[1]);
       pageSel[1]= LMSL_CTRL_PAGE;
-      r= lxi2cWriteRB(pC, busAddr, pageSel, sizeof(pageSel));
+      r= lxi2cShadowWriteRB(&sh, pageSel, sizeof(pageSel));
    }
 
    cp.addr[0]= 0x00;
-   r= lxi2cReadRB(pC, busAddr, cp.addr, sizeof(ControlPage));
+   r= lxi2cShadowReadRB(&sh, cp.addr, sizeof(ControlPage));
    LOG("Read Control Page - r=%d\n", r);
    if (r >= 0) { dumpReg(&cp); }
 
@@ -224,10 +231,10 @@ int ledMatHack (const LXI2CBusCtx *pC, const U8 busAddr, const U8 modeFlags)
    while (--iPage >= 0)
    {
       pageSel[1]= iPage;
-      r= lxi2cWriteRB(pC, busAddr, pageSel, sizeof(pageSel));
+      r= lxi2cShadowWriteRB(&sh, pageSel, sizeof(pageSel));
       if (0)
       {  // copy existing from device
-         r= lxi2cReadRB(pC, busAddr, frames[iPage].addr, sizeof(FramePage));
+         r= lxi2cShadowReadRB(&sh, frames[iPage].addr, sizeof(FramePage));
          LOG("Read Frame Page - r=%d\n", r);
       }
       else if (iPage > 0) { memcpy(frames+iPage, frames+0, sizeof(frames[0])); }
@@ -235,7 +242,7 @@ int ledMatHack (const LXI2CBusCtx *pC, const U8 busAddr, const U8 modeFlags)
       n= chanTestSetData(frames+iPage, pwmRGB, iPage, 3, 0x85);
       if (n > 0)
       {
-         r= lxi2cWriteRB(pC, busAddr, frames[iPage].addr, n);
+         r= lxi2cShadowWriteRB(&sh, frames[iPage].addr, n);
          LOG("Write Frame Page [%d] - %d Bytes r=%d\n", iPage, n, r);
       }
    }
@@ -244,7 +251,7 @@ int ledMatHack (const LXI2CBusCtx *pC, const U8 busAddr, const U8 modeFlags)
    {
       t= pageSel[1];
       pageSel[1]= LMSL_CTRL_PAGE;
-      r= lxi2cWriteRB(pC, busAddr, pageSel, sizeof(pageSel));
+      r= lxi2cShadowWriteRB(&sh, pageSel, sizeof(pageSel));
       LOG("Control Page Select - r=%d\n", r);
       if (r < 0) { pageSel[1]= t; }
    }
@@ -260,7 +267,7 @@ int ledMatHack (const LXI2CBusCtx *pC, const U8 busAddr, const U8 modeFlags)
          cp.reg[LMSL_REG_DISPOPT]= 0; // off |= (1<<3) | 1;
          n= 2+LMSL_REG_DISPOPT;
       }
-      r= lxi2cWriteRB(pC, busAddr, cp.addr, n);
+      r= lxi2cShadowWriteRB(&sh, cp.addr, n);
 
       // Split because FS reg 0x7 is read only
       if (1) // 0 == (cp.reg[LMSL_REG_SHUTDOWN] & 0x1))
@@ -271,13 +278,13 @@ int ledMatHack (const LXI2CBusCtx *pC, const U8 busAddr, const U8 modeFlags)
          setFade(cp.reg+LMSL_REG_BREATHE1, 0, 5, 0, 0);
          cp.reg[LMSL_REG_SHUTDOWN]= 0x01; // enable
 
-         r= lxi2cWriteRB(pC, busAddr, cp.reg+i, 1+LMSL_REG_SHUTDOWN-i);
+         r= lxi2cShadowWriteRB(&sh, cp.reg+i, 1+LMSL_REG_SHUTDOWN-i);
          cp.reg[i]= t; // restore
       }
    }
 
    sleep(1);
-   r= lxi2cReadRB(pC, busAddr, cp.addr, sizeof(ControlPage));
+   r= lxi2cShadowReadRB(&sh, cp.addr, sizeof(ControlPage));
    LOG("Read Control Page - r=%d\n", r);
    if (r >= 0) { dumpReg(&cp); }
 
@@ -287,10 +294,13 @@ int ledMatHack (const LXI2CBusCtx *pC, const U8 busAddr, const U8 modeFlags)
       if (LMSL_CTRL_PAGE == pageSel[1])
       {
          U8 sd[2]= {LMSL_REG_SHUTDOWN, 0x00}; // shutdown
-         r= lxi2cWriteRB(pC, busAddr, sd, 2);
+         r= lxi2cShadowWriteRB(&sh, sd, 2);
       }
    }
 
+   LOG("Shadow: %u writes skipped, %u reads cached, %u bus transactions, %u bytes saved\n",
+      sh.nWrSkip, sh.nRdHit, sh.nWrBus + sh.nRdBus, sh.nByteSaved);
+   lxi2cShadowRelease(&sh);
    if (r > 0) { r= 0; }
    return(r);
 } // ledMatHack
@@ -3,10 +3,12 @@
 // Licence: GPL V3
 // (c) Project Contributors Oct 2020
 
+#include <errno.h>
 #include "ubxDev.h"
 #include "ubxUtil.h"
 #include "ubxDissect.h"
 #include "ubxDebug.h"
+#include "lxRetry.h"
 
 
 /***/
@@ -14,15 +16,18 @@
 typedef struct
 {
    const LXI2CBusCtx *pI2C;
-   U8    busAddr, retry;
+   LXRetryStat *pRS; // optional
+   LXRetryPolicy retry;
+   U8    busAddr;
    U16   chunk;   // i2c-bus stream transaction granularity
-   U32   syncus;
+   U32   syncus;  // settling delay following configuration commands
 } UBXInfoDDS;
 
 typedef struct
 {
    MemBuff     mb;
    UBXInfoDDS dds;
+   LXRetryStat rs;
    // Working buffers / storage
    LXUARTCtx uart;
 } UBXCtx;
@@ -37,16 +42,17 @@ INLINE int endFrag (const FragBuff16 *pF, const int ext) { return(pF->offset + p
 
 int ubxGetAvailDDS (const UBXInfoDDS *pD)
 {
-   int t= pD->retry;
+   LXRetry rt;
    U8 io[3];
+   int r;
 
    io[0]= UBXM8_RG_NBYTE_HI;
+   lxRetryBegin(&rt, &(pD->retry), pD->pRS);
    do
    {
-      int r= lxi2cReadRB(pD->pI2C, pD->busAddr, io, 3);
-      if (r >= 0) { return rdU16BE(io+1); }
-      else if (t > 0) { ubxSyncDDS(pD); }
-   } while (t-- > 0);
+      r= lxi2cReadRB(pD->pI2C, pD->busAddr, io, 3);
+   } while ((r < 0) && lxRetryAgain(&rt, errno));
+   if (lxRetryEnd(&rt, r) >= 0) { return rdU16BE(io+1); }
    return(-1);
 } // ubxGetAvailDDS
 
@@ -60,14 +66,15 @@ int iclamp (int x, const int min, const int max)
 
 int ubxWriteDDS (const UBXInfoDDS *pD, const U8 msg[], const int msgLen)
 {
-   int r, t= pD->retry;
+   LXRetry rt;
+   int r;
+
+   lxRetryBegin(&rt, &(pD->retry), pD->pRS);
    do
    {
       r= lxi2cWriteRB(pD->pI2C, pD->busAddr, msg, msgLen);
-      if (r >= 0) { return(r); }
-      else if (t > 0) { ubxSyncDDS(pD); }
-   } while (t-- > 0);
-   return(-1);
+   } while ((r < 0) && lxRetryAgain(&rt, errno));
+   return lxRetryEnd(&rt, (r >= 0) ? r : -1);
 } // ubxWriteDDS
 
 int ubxReadDDS (const MemBuff *pMB, const UBXInfoDDS *pD, const int avail, const int expectPld)
@@ -76,15 +83,17 @@ int ubxReadDDS (const MemBuff *pMB, const UBXInfoDDS *pD, const int avail, const
    int chunk=  MIN(pD->chunk, bT);
    U8 *pB=  pMB->p;
    int bR=  0;   // Result
-   int r, t= pD->retry;
+   int r;
+   LXRetry rt;
+
+   lxRetryBegin(&rt, &(pD->retry), pD->pRS); // NB: retries shared by all chunks
    do // Repeated chunk read (no register update necessary)
    {
       pB[bR]= UBXM8_DSB_INVALID;  // set guard byte
       r= lxi2cReadStream(pD->pI2C, pD->busAddr, pB+bR, chunk);
       if ((r < 0) || (UBXM8_DSB_INVALID == pB[bR]))
-      {
-         if (t-- > 0) { ubxSyncDDS(pD); }
-         else { chunk= 0; } // give up
+      {  // Invalid data byte: stream not (yet) available
+         if (!lxRetryAgain(&rt, (r < 0) ? errno : 0)) { chunk= 0; } // give up
       }
       else
       {
@@ -93,6 +102,7 @@ int ubxReadDDS (const MemBuff *pMB, const UBXInfoDDS *pD, const int avail, const
          if (r < chunk) { chunk= r; }
       }
    } while (chunk > 0);
+   lxRetryEnd(&rt, (bR > 0) ? bR : -1);
    return(bR);
 } // ubxReadDDS
 
@@ -174,15 +184,22 @@ int ubxReadAvailStream (FragBuff16 *pFB, const UBXCtx *pUC)
 */
 
 void initCtx (UBXCtx *pUC, const LXI2CBusCtx *pI2C, const LXUARTCtx *pU, const U8 busAddr, const size_t bytes)
-{
+{  // Data not ready or NAK: jittered exponential backoff 0.5..4ms within 8ms. Other
+   // errors (e.g. EIO) retried as previously (3 times), at most 4 retries overall
+   static const LXRetryPolicy ddsRetry=
+   {  500000, 4000000, 8000000, // backoff base & max, budget (ns)
+      {4, 4, 1, 3}, LX_RETRY_JITTER, 4  // AGAIN, NAK, TIMEOUT, OTHER ; mode, maxTotal
+   };
    //lxUARTOpen(&(pC->uart), "/dev/ttyS0");
    if (allocMemBuff(&(pUC->mb), bytes))
    {
       pUC->dds.pI2C= pI2C;
       pUC->dds.busAddr= busAddr;
-      pUC->dds.retry=   3;
+      pUC->dds.retry=   ddsRetry;
       pUC->dds.chunk=   16;
       pUC->dds.syncus=  2000;
+      memset(&(pUC->rs), 0, sizeof(pUC->rs));
+      pUC->dds.pRS=     &(pUC->rs);
    }
 } // initCtx
 
@@ -423,6 +440,7 @@ int ubxTest (const LXI2CBusCtx *pC, const U8 busAddr)
          usleep(500000);
       } while (n++ < m);
       r= ubxSetRate(UBXM8_CL_NAV, UBXM8_ID_PVT, 0, &ctx);
+      lxRetryDump("DDS retry", &(ctx.rs), OUT);
    }
    releaseCtx(&ctx);
    return(r);
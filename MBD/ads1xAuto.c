@@ -24,35 +24,160 @@ F32 ads1xGainScaleV (const U8 cfg[1], const ADS1xHWID x)
    return ads1xGainToFSV( ads1xGetGain(cfg) ) * rawFS[x];
 } // ads1xGainScaleV
 
+int convertRawAGR (F32 f[], const RawAGR r[], const int n, const ADSInstProp *pP)
+{
+   for (int i=0; i<n; i++)
+   {
+      if (r[i].flSt & AGR_FLAG_VROK) { f[i]= r[i].res * ads1xGainScaleV(r[i].cfgRB0, pP->hwID); }
+      else { f[i]= 0; }
+   }
+   return(n);
+} // convertRawAGR
+
 
 /***/
 
+// Check reading against gain setting, adjusting gain where precision can
+// be improved or range has been exceeded. Returns non-zero if changed
+// (i.e. another conversion would be worthwhile).
+static int autoGainAGR (RawAGR *pR, const int vr, const AutoRawCtx *pARC)
+{
+   U8 gainID= ads1xGetGain(pR->cfgRB0);
+   int tFSR= (int)(pARC->fsr) / 2;
+   if ((vr < tFSR) && (gainID < ADS1X_GAIN_0V256))
+   {
+      do // Search for appropriate gain to improve
+      {  // precision based on last reading
+         gainID++;
+         tFSR/= 2;
+      } while ((vr < tFSR) && (gainID < ADS1X_GAIN_0V256));
+      ads1xSetGain(pR->cfgRB0, gainID);
+      return(1);
+   }
+   else if ((vr >= pARC->fsr) && (gainID > ADS1X_GAIN_6V144))
+   {  // Reduce gain by half
+      gainID/= 2;
+      ads1xSetGain(pR->cfgRB0, gainID);
+      return(1);
+   }
+   return(0);
+} // autoGainAGR
+
+// Set final status info, returns 1 if valid result
+static int statusAGR (RawAGR *pR, const int vr, const U8 iTrans, const int fsr)
+{
+   int v= 0;
+   if (0 == (pR->flSt & AGR_FLAG_ORNG))
+   {
+      if ((vr >= fsr) || (vr <= -(fsr+1))) { pR->flSt|= AGR_FLAG_ORNG; }
+      else
+      {
+         pR->flSt|= AGR_FLAG_VROK;
+         v= 1;
+      }
+   }
+   pR->res= vr;
+   pR->flSt|= RMG_MASK_TRNS & iTrans;
+   return(v);
+} // statusAGR
+
+// Predictive gain: history smoothing factor, margin (std. dev.) on predicted
+// magnitude, and fraction of range usable when raising or holding gain. The
+// difference between the two fractions provides hysteresis.
+#define PG_ALPHA  (0.25f)
+#define PG_SIGMA  (3.0f)
+#define PG_UP     (0.70f)
+#define PG_HOLD   (0.95f)
+
+// With prediction active, re-conversion is only worthwhile when the reading
+// over-ranges or falls below a quarter of range (two bits of precision lost).
+static int rangeFaultPG (const int vr, const int fsr)
+{
+   const int a= abs(vr);
+   return((a >= fsr) || (a < (fsr >> 2)));
+} // rangeFaultPG
+
+// Select gain ahead of conversion from the predicted magnitude of the next
+// reading on mux channel i. Returns 1 if gain was changed.
+static int predictGainAGR (RawAGR *pR, const AutoRawCtx *pARC, const int i)
+{
+   const ADSGainHist *pH;
+   if ((NULL == pARC->pPG) || (0 == (pR->flSt & AGR_FLAG_AUTO))) { return(0); }
+   pH= pARC->pPG->h+i;
+   if (pH->n >= 2)
+   {
+      const U8 curG= ads1xGetGain(pR->cfgRB0);
+      const F32 m= fabsf(pH->last + pH->slope) + PG_SIGMA * sqrtf(pH->var);
+      U8 g= ADS1X_GAIN_0V256;
+      while ((g > ADS1X_GAIN_6V144) && (m >= ads1xGainToFSV(g) * ((g > curG) ? PG_UP : PG_HOLD))) { g--; }
+      if (g != curG)
+      {
+         ads1xSetGain(pR->cfgRB0, g);
+         pARC->pPG->nPred++;
+         return(1);
+      }
+   }
+   return(0);
+} // predictGainAGR
+
+// Update history of mux channel i with final reading (status already set)
+// obtained using the specified config (i.e. gain, which may differ from the
+// result record when a change is pending).
+static void updateGainHistAGR (const RawAGR *pR, const U8 cfgUsed[1], const AutoRawCtx *pARC, const int i, const int pred)
+{
+   ADSPredGain *pPG= pARC->pPG;
+   ADSGainHist *pH;
+   if ((NULL == pPG) || (0 == (pR->flSt & AGR_FLAG_AUTO))) { return; }
+   pH= pPG->h+i;
+   if (pR->flSt & AGR_FLAG_VROK)
+   {
+      const F32 v= pR->res * ads1xGainToFSV(ads1xGetGain(cfgUsed)) / pARC->fsr;
+      const U8 nTrans= pR->flSt & RMG_MASK_TRNS;
+      if (pH->n > 1)
+      {
+         const F32 e= (v - pH->last) - pH->slope;
+         pH->slope+= PG_ALPHA * e;
+         pH->var= (1 - PG_ALPHA) * (pH->var + PG_ALPHA * e * e);
+      }
+      else if (pH->n > 0)
+      {  // Conservative initial estimate
+         pH->slope= v - pH->last;
+         pH->var= pH->slope * pH->slope;
+      }
+      pH->last= v;
+      if (pH->n < 0xFF) { pH->n++; }
+      if (nTrans > 2) { pPG->nReConv++; }
+      else if (pred) { pPG->nSaved++; }
+   }
+   else { pH->n= 0; } // Restart history
+} // updateGainHistAGR
+
 // Read a set of mux channels, updating the gain setting for each to maximise precison.
 // Performs multiple reads per channel as appropriate, if permitted.
 // Optionally provides transaction timing information
 int readAutoRawADS1x (RawAGR agr[], ExtRawTiming *pT, int nR, RawTimeStamp *pTarget, AutoRawCtx *pARC)
 {
    RawTimeStamp wait[3];
-   int n=0, r=-1, vr, tFSR; // intermediate values at machine word-length: intended to reduce operations
-   U8 resPB[ADS1X_NRB], gainID, iTrans;
+   int n=0, r=-1, vr; // intermediate values at machine word-length: intended to reduce operations
+   U8 resPB[ADS1X_NRB], iTrans;
 
    resPB[0]= ADS1X_REG_RES;
    for (int i=0; i<nR; i++)
    {  // per-mux iteration
       vr= 0; iTrans= 0; // clean start
       agr[i].flSt&= AGR_FLAG_AUTO|AGR_FLAG_SGND; // clear status, preserve setting
-      gainID= ads1xGetGain(agr[i].cfgRB0);
+      const int pred= predictGainAGR(agr+i, pARC, i);
       if (pARC->ivlNanoSec[1] > 0)
       {
          timeSpinWaitUntil(wait+0, pTarget);
          if (pT) { pT[i].ts[EXT_RTS_MUXCH_BGN]= wait[0]; }
          timeSetTarget(pTarget, NULL, pARC->ivlNanoSec[1], TIME_MODE_RELATIVE);
-      } else if (pT) { timeStamp(pT[i].ts+EXT_RTS_MUXCH_BGN); } // MUX channel begin
+      } else if (pT && (pARC->tsMask & (1<<EXT_RTS_MUXCH_BGN))) { timeStamp(pT[i].ts+EXT_RTS_MUXCH_BGN); } // MUX channel begin
 
       do
       {  // Get best available reading
          pARC->cfgPB[1]= agr[i].cfgRB0[0]; // Sets Gain, Mux, flags (Single Shot & Start)
-         if (pT) { timeStamp(pT[i].ts+EXT_RTS_WRCFG_BGN); }  // Config write begin
+         if (pT && (pARC->tsMask & (1<<EXT_RTS_WRCFG_BGN))) { timeStamp(pT[i].ts+EXT_RTS_WRCFG_BGN); }  // Config write begin
          r= lxi2cWriteRB(pARC->pC, pARC->busAddr, pARC->cfgPB, ADS1X_NRB);
          if (r > 0)
          {  // Config write complete, conversion started
@@ -64,7 +189,7 @@ int readAutoRawADS1x (RawAGR agr[], ExtRawTiming *pT, int nR, RawTimeStamp *pTar
             {  // got result
                if (pT)
                {
-                  timeStamp(pT[i].ts+EXT_RTS_RDVAL_END);  // Read complete
+                  if (pARC->tsMask & (1<<EXT_RTS_RDVAL_END)) { timeStamp(pT[i].ts+EXT_RTS_RDVAL_END); }  // Read complete
                   pT[i].ts[EXT_RTS_RDVAL_BGN]= wait[2];   // Wait done / begin read
                   pT[i].ts[EXT_RTS_WRCFG_END]= wait[0];   // Write complete
                }
@@ -77,44 +202,223 @@ int readAutoRawADS1x (RawAGR agr[], ExtRawTiming *pT, int nR, RawTimeStamp *pTar
                }
                else if (agr[i].flSt & AGR_FLAG_AUTO)
                {  // Check for better gain setting
-                  tFSR= (int)(pARC->fsr) / 2;
-                  if ((vr < tFSR) && (gainID < ADS1X_GAIN_0V256))
-                  {
-                     do // Search for appropriate gain to improve
-                     {  // precision based on last reading
-                        gainID++;
-                        tFSR/= 2;
-                     } while ((vr < tFSR) && (gainID < ADS1X_GAIN_0V256));
-                     ads1xSetGain(agr[i].cfgRB0, gainID);
-                  }
-                  else if ((vr >= pARC->fsr) && (gainID > ADS1X_GAIN_6V144))
-                  {  // Reduce gain by half
-                     gainID/= 2;
-                     ads1xSetGain(agr[i].cfgRB0, gainID);
-                  }
-                  else { r= 0; } // done
+                  if (pARC->pPG && !rangeFaultPG(vr, pARC->fsr)) { r= 0; } // prediction adequate
+                  else if (0 == autoGainAGR(agr+i, vr, pARC)) { r= 0; } // done
                }
             } // Result
          } // Start
       } while ((r > 0) && (iTrans < pARC->maxTrans));
       if (r >= 0)
-      { // Set final status info
-         const int fsr= pARC->fsr;
-         if (0 == (agr[i].flSt & AGR_FLAG_ORNG))
+      {
+         n+= statusAGR(agr+i, vr, iTrans, pARC->fsr);
+         updateGainHistAGR(agr+i, pARC->cfgPB+1, pARC, i, pred);
+      }
+   }
+   return(n);
+} // readAutoRawADS1x
+
+// Pipelined scan: the result of channel i is read and the config for channel i+1
+// written (thereby starting the next conversion) in a single combined transaction,
+// so a scan of nR channels costs nR+1 rather than 2*nR system calls. Re-conversion
+// would stall the pipeline, so any auto-gain adjustment is deferred to the next scan.
+// Output (results & timing) is otherwise equivalent to readAutoRawADS1x().
+int readPipeRawADS1x (RawAGR agr[], ExtRawTiming *pT, int nR, RawTimeStamp *pTarget, AutoRawCtx *pARC)
+{
+   RawTimeStamp wait[3];
+   int n=0, r=-1, vr;
+   U8 resPB[ADS1X_NRB], pred[ADS1X_MUX_MAX];
+
+   if (nR <= 0) { return(0); }
+   resPB[0]= ADS1X_REG_RES;
+   for (int i=0; i<nR; i++)
+   {  // NB: result records retain gain used until each channel is reconfigured
+      RawAGR t;
+      agr[i].flSt&= AGR_FLAG_AUTO|AGR_FLAG_SGND; // clear status, preserve setting
+      t= agr[i];
+      if (pARC->maskNext & (1<<i)) { t.cfgRB0[0]= pARC->cfgNext[i]; } // deferred change
+      pred[i]= predictGainAGR(&t, pARC, i);
+      pARC->cfgNext[i]= t.cfgRB0[0];
+      pARC->maskNext|= 1<<i; // pending until conversion started
+   }
+
+   // Prime pipeline: start conversion on first channel
+   if (pARC->ivlNanoSec[1] > 0)
+   {
+      timeSpinWaitUntil(wait+2, pTarget);
+      timeSetTarget(pTarget, NULL, pARC->ivlNanoSec[1], TIME_MODE_RELATIVE);
+   } else { timeStamp(wait+2); }
+   if (pT) { pT[0].ts[EXT_RTS_MUXCH_BGN]= pT[0].ts[EXT_RTS_WRCFG_BGN]= wait[2]; }
+   pARC->cfgPB[1]= pARC->cfgNext[0];
+   r= lxi2cWriteRB(pARC->pC, pARC->busAddr, pARC->cfgPB, ADS1X_NRB);
+   if (r > 0) { agr[0].cfgRB0[0]= pARC->cfgNext[0]; pARC->maskNext&= ~1; }
+   timeSetTarget(wait+1, wait+0, pARC->ivlNanoSec[0], TIME_MODE_NOW);
+   if (pT) { pT[0].ts[EXT_RTS_WRCFG_END]= wait[0]; }
+
+   for (int i=0; (i<nR) && (r > 0); i++)
+   {
+      const int j= i+1;
+      timeSpinWaitUntil(wait+2, wait+1); // Wait for conversion
+      if (j < nR)
+      {
+         if (pARC->ivlNanoSec[1] > 0)
          {
-            if ((vr >= fsr) || (vr <= -(fsr+1))) { agr[i].flSt|= AGR_FLAG_ORNG; }
-            else
+            timeSpinWaitUntil(wait+2, pTarget);
+            timeSetTarget(pTarget, NULL, pARC->ivlNanoSec[1], TIME_MODE_RELATIVE);
+         }
+         pARC->cfgPB[1]= pARC->cfgNext[j]; // NB: record j updated once result i extracted
+         r= lxi2cReadWriteRB(pARC->pC, pARC->busAddr, resPB, ADS1X_NRB, pARC->cfgPB, ADS1X_NRB);
+      }
+      else { r= lxi2cReadRB(pARC->pC, pARC->busAddr, resPB, ADS1X_NRB); }
+      timeSetTarget(wait+1, wait+0, pARC->ivlNanoSec[0], TIME_MODE_NOW); // NB: next conversion (if any) now started
+      if (pT)
+      {
+         pT[i].ts[EXT_RTS_RDVAL_BGN]= wait[2];
+         pT[i].ts[EXT_RTS_RDVAL_END]= wait[0];
+         if (j < nR)
+         {  // shared transaction
+            pT[j].ts[EXT_RTS_MUXCH_BGN]= pT[j].ts[EXT_RTS_WRCFG_BGN]= wait[2];
+            pT[j].ts[EXT_RTS_WRCFG_END]= wait[0];
+         }
+      }
+      if (r > 0)
+      {
+         RawAGR t= agr[i]; // NB: result retains gain used, any change deferred to next scan
+         vr= rdI16BE(resPB+1);
+         if ((vr < 0) && (agr[i].flSt & AGR_FLAG_SGND)) { agr[i].flSt|= AGR_FLAG_ORNG; }
+         else if ((agr[i].flSt & AGR_FLAG_AUTO) && ((NULL == pARC->pPG) || rangeFaultPG(vr, pARC->fsr)))
+         {
+            if (autoGainAGR(&t, vr, pARC))
             {
-               agr[i].flSt|= AGR_FLAG_VROK;
-               ++n;
+               pARC->cfgNext[i]= t.cfgRB0[0];
+               pARC->maskNext|= 1<<i;
             }
          }
-         agr[i].res= vr;
-         agr[i].flSt|= RMG_MASK_TRNS & iTrans;
+         n+= statusAGR(agr+i, vr, 2, pARC->fsr);
+         updateGainHistAGR(agr+i, agr[i].cfgRB0, pARC, i, pred[i]);
+      }
+      if ((r > 0) && (j < nR))
+      {  // conversion j started with new config
+         agr[j].cfgRB0[0]= pARC->cfgNext[j];
+         pARC->maskNext&= ~(1<<j);
       }
    }
    return(n);
-} // readAutoRawADS1x
+} // readPipeRawADS1x
+
+// Continuous conversion streaming (single channel). The device is configured
+// once then left with its address pointer on the result register, so that
+// each sample costs a single 2 byte read with no register/config traffic.
+int startContADS1x (const RawAGR *pR, AutoRawCtx *pARC)
+{
+   U8 reg[1]={ADS1X_REG_RES};
+   int r;
+   pARC->cfgPB[1]= pR->cfgRB0[0] & ~(ADS1X_FL0_OS|ADS1X_FL0_MODE); // MODE=0 -> continuous
+   r= lxi2cWriteRB(pARC->pC, pARC->busAddr, pARC->cfgPB, ADS1X_NRB);
+   if (r > 0) { r= lxi2cWriteRB(pARC->pC, pARC->busAddr, reg, 1); }
+   return(r);
+} // startContADS1x
+
+// Read up to nR samples at the data rate (or inner rate if slower), timestamping
+// completion of each read. Auto-gain (if enabled) reconfigures the stream
+// only when a change is required. Returns the number of records filled (a
+// range fault still fills its record), stopping at the first bus error which
+// is returned via *pErr (optional, 0 if none).
+int readContRawADS1x (RawAGR agr[], RawTimeStamp ts[], int nR, RawTimeStamp *pTarget, AutoRawCtx *pARC, int *pErr)
+{
+   const long ivl= MAX(pARC->ivlNanoSec[0], pARC->ivlNanoSec[1]);
+   RawTimeStamp wait[1];
+   int n=0, r=1, vr;
+   U8 res[2];
+
+   while ((n < nR) && (r > 0))
+   {
+      RawAGR *pR= agr+n;
+      pR->cfgRB0[0]= pARC->cfgPB[1];
+      pR->flSt&= AGR_FLAG_AUTO|AGR_FLAG_SGND;
+      timeSpinWaitUntil(wait+0, pTarget);
+      timeSetTarget(pTarget, NULL, ivl, TIME_MODE_RELATIVE);
+      r= lxi2cReadStream(pARC->pC, pARC->busAddr, res, 2);
+      if (r <= 0) { break; }
+      if (ts) { timeStamp(ts+n); }
+      vr= rdI16BE(res);
+      if ((vr < 0) && (pR->flSt & AGR_FLAG_SGND)) { pR->flSt|= AGR_FLAG_ORNG; }
+      else if (pR->flSt & AGR_FLAG_AUTO)
+      {
+         RawAGR t= *pR; // NB: result retains gain used
+         if (autoGainAGR(&t, vr, pARC))
+         {  // Restart stream: allow conversion in progress (old setting) to complete
+            r= startContADS1x(&t, pARC);
+            timeSetTarget(pTarget, NULL, 2*ivl, TIME_MODE_NOW);
+         }
+      }
+      statusAGR(pR, vr, 1, pARC->fsr);
+      n++;
+   }
+   if (pErr) { *pErr= (r > 0) ? 0 : MIN(-1, r); }
+   return(n);
+} // readContRawADS1x
+
+// Return device to single shot (power down) mode
+int stopContADS1x (AutoRawCtx *pARC)
+{
+   pARC->cfgPB[1]= (pARC->cfgPB[1] & ~ADS1X_FL0_OS) | ADS1X_FL0_MODE;
+   return lxi2cWriteRB(pARC->pC, pARC->busAddr, pARC->cfgPB, ADS1X_NRB);
+} // stopContADS1x
+
+// Read device config (into cfgPB) and update data rate if necessary
+int ads1xSyncRate (U8 cfgPB[ADS1X_NRB], const LXI2CBusCtx *pC, const U8 busAddr, const enum ADS1xRate rateID)
+{
+   int r;
+   cfgPB[0]= ADS1X_REG_CFG;
+   r= lxi2cReadRB(pC, busAddr, cfgPB, ADS1X_NRB);
+   if (r > 0)
+   {
+      if (rateID == ads1xGetRate(cfgPB+1)) { r= 1; }
+      else
+      {
+         ads1xSetRate(cfgPB+1, rateID);
+         r= lxi2cWriteRB(pC, busAddr, cfgPB, ADS1X_NRB);
+      }
+   }
+   return(r);
+} // ads1xSyncRate
+
+// Internal oscillator tolerance (ADS1x15 datasheet: +/-10%)
+#define ADS1X_OSC_TOL (0.1)
+
+int ads1xPlanRate (ADSRatePlan *pRP, ADSReadParam *pM, const U16 chanRate[], const F32 reconv, const int clk, const long ovhdNS, const ADS1xHWID hwID)
+{
+   const long wireNS= ADS1X_TRANS_NCLK * (F64)NANO_TICKS / clk;
+   const F32 convPerScan= pM->nMux * (1 + MAX(0, reconv));
+   const int maxID= (ADS10 == hwID) ? ADS10_DR3300 : ADS11_DR860;
+   U16 scanRate= 0;
+   int id, ok= 0;
+
+   memset(pRP, 0, sizeof(*pRP));
+   if ((pM->nMux <= 0) || (clk <= 0)) { return(-1); }
+   for (int i=0; i<pM->nMux; i++) { scanRate= MAX(scanRate, chanRate[i]); }
+   if (scanRate <= 0) { return(-1); }
+
+   pRP->scanRate= scanRate;
+   pRP->transNS= wireNS + ovhdNS;
+   for (id= 0; id <= maxID; id++)
+   {  // Slowest first: lower data rates give lower noise
+      pRP->convNS= (1 + ADS1X_OSC_TOL) * NANO_TICKS / ads1xRateToU(id, hwID);
+      pRP->scanNS= convPerScan * (pRP->convNS + 2 * pRP->transNS);
+      if (pRP->scanNS * (F64)scanRate <= NANO_TICKS) { ok= 1; break; }
+   }
+   if (id > maxID) { id= maxID; }
+   pRP->rateID= id;
+   pRP->spareNS= NANO_TICKS / scanRate - pRP->scanNS;
+   pRP->busUtil= scanRate * convPerScan * 2 * wireNS * (1.0 / NANO_TICKS);
+   pM->rate[0]= scanRate;
+   pM->rate[1]= ads1xRateToU(id, hwID); // No inner delay: conversion paced by hardware
+   if (!ok)
+   {
+      WARN_CALL("() - %d Hz x %d channels infeasible: max scan rate %G Hz\n", scanRate, pM->nMux, (F64)NANO_TICKS / pRP->scanNS);
+   }
+   return(ok);
+} // ads1xPlanRate
 
 U8 setupRawAGR (RawAGR r[], const U8 mux[], U8 n, const U8 maskAG, const enum ADS1xGain initGain)
 {
@@ -122,7 +426,8 @@ U8 setupRawAGR (RawAGR r[], const U8 mux[], U8 n, const U8 maskAG, const enum AD
    for (int i=0; i<n; i++)
    {  // set config byte to start single conversion (plus gain & mux)
       ads1xGenCfgRB0(r[i].cfgRB0, mux[i], initGain, ADS1X_FL0_OS|ADS1X_FL0_MODE);
-      if (maskAG & (1<<n)) { r[i].flSt= AGR_FLAG_AUTO; }
+      r[i].flSt= 0;
+      if (maskAG & (1<<i)) { r[i].flSt= AGR_FLAG_AUTO; }
       if (mux[i] >= ADS1X_MUX0G) { r[i].flSt|= AGR_FLAG_SGND; }
    }
    return(n);
@@ -137,6 +442,9 @@ int setupAEC (AutoExtCtx *pAEC, const ADSInstProp *pP, const ADSReadParam *pM, c
    {
       r= 0;
       pAEC->arc.pC= pC;
+      pAEC->arc.pPG= NULL;
+      pAEC->arc.maskNext= 0;
+      pAEC->arc.tsMask= EXT_RTS_MASK_ALL;
       if (pCfgPB) { memcpy(pAEC->arc.cfgPB, pCfgPB, ADS1X_NRB); } // Paranoid VALIDATE ?
       else
       {
@@ -165,7 +473,7 @@ int setupAEC (AutoExtCtx *pAEC, const ADSInstProp *pP, const ADSReadParam *pM, c
       pAEC->arc.busAddr= pP->busAddr;
       if (softRate > 0)
       {
-         const long i2cTransWait= ADS1X_TRANS_NCLK * (float)NANO_TICKS / pC->clk;
+         const long i2cTransWait= lxi2cTransNS(pC, ADS1X_TRANS_NCLK);
          const long hardTime= (pAEC->arc.ivlNanoSec[0] + 2 * i2cTransWait);
          const long window= pAEC->outerIvlNanoSec / pAEC->arc.nMux;
          pAEC->arc.maxTrans= 2*(window / hardTime);
@@ -177,3 +485,137 @@ int setupAEC (AutoExtCtx *pAEC, const ADSInstProp *pP, const ADSReadParam *pM, c
    return(r);
 } // setupAEC
 
+
+/***/
+
+// Multiple devices sharing a bus: each device is driven through its own
+// sequence of "start conversion" and "read result" events, the scheduler
+// servicing whichever event falls due earliest. Conversions on all devices
+// are thus started together and the conversion waits overlap.
+#define MULTI_EV_NONE  (0)
+#define MULTI_EV_START (1)
+#define MULTI_EV_READ  (2)
+
+typedef struct
+{
+   RawTimeStamp due;
+   int   vr;
+   U8    ev, iMux, iTrans, pred;
+} MultiDevState;
+
+int setupMultiAEC (ADSMultiCtx *pMC, const ADSInstProp ip[], int nDev, const ADSReadParam *pM, const LXI2CBusCtx *pC)
+{
+   U8 cfgPB[ADS1X_NRB];
+   int r= -1;
+
+   if (nDev > ADS1X_DEV_MAX) { WARN_CALL("(..nDev=%d..) - clamped to ADS1X_DEV_MAX=%d\n", nDev, ADS1X_DEV_MAX); nDev= ADS1X_DEV_MAX; }
+   pMC->nDev= 0;
+   for (int d=0; d<nDev; d++)
+   {
+      r= ads1xSyncRate(cfgPB, pC, ip[d].busAddr, ads1xSelectRate(pM->rate[1], ip[d].hwID));
+      if (r <= 0) { ERROR_CALL("() - device 0x%02X - %d\n", ip[d].busAddr, r); return(-1); }
+      r= setupAEC(pMC->aec+d, ip+d, pM, cfgPB, pC);
+      if (r < 0) { return(r); }
+      pMC->nDev++;
+   }
+   return(pMC->nDev);
+} // setupMultiAEC
+
+int readMultiRawADS1x (ADSMultiCtx *pMC, ExtRawTiming *pT[])
+{
+   MultiDevState ds[ADS1X_DEV_MAX];
+   RawTimeStamp now;
+   U8 resPB[ADS1X_NRB];
+   int n=0, r, iD;
+
+   resPB[0]= ADS1X_REG_RES;
+   timeStamp(&now);
+   for (int d=0; d<pMC->nDev; d++)
+   {
+      AutoExtCtx *pE= pMC->aec+d;
+      ds[d].vr= 0; ds[d].iMux= 0; ds[d].iTrans= 0;
+      if (pE->arc.nMux > 0) { ds[d].ev= MULTI_EV_START; } else { ds[d].ev= MULTI_EV_NONE; }
+      if (pE->arc.ivlNanoSec[1] > 0) { ds[d].due= pE->targetTS[1]; } else { ds[d].due= now; }
+      for (int i=0; i<pE->arc.nMux; i++) { pE->rawAGR[i].flSt&= AGR_FLAG_AUTO|AGR_FLAG_SGND; } // clear status, preserve setting
+   }
+   do
+   {  // Find earliest event
+      iD= -1;
+      for (int d=0; d<pMC->nDev; d++)
+      {
+         if ((MULTI_EV_NONE != ds[d].ev) && ((iD < 0) || timeBefore(&(ds[d].due), &(ds[iD].due)))) { iD= d; }
+      }
+      if (iD >= 0)
+      {
+         MultiDevState *pS= ds+iD;
+         AutoExtCtx *pE= pMC->aec+iD;
+         RawAGR *pR= pE->rawAGR + pS->iMux;
+         ExtRawTiming *pET= NULL;
+         int more= 0;
+
+         if (pT && pT[iD]) { pET= pT[iD] + pS->iMux; }
+         timeSpinWaitUntil(&now, &(pS->due));
+         if (MULTI_EV_START == pS->ev)
+         {
+            if (0 == pS->iTrans)
+            {  // MUX channel begin
+               pS->pred= predictGainAGR(pR, &(pE->arc), pS->iMux);
+               if (pET) { pET->ts[EXT_RTS_MUXCH_BGN]= now; }
+               if (pE->arc.ivlNanoSec[1] > 0) { timeSetTarget(pE->targetTS+1, NULL, pE->arc.ivlNanoSec[1], TIME_MODE_RELATIVE); }
+            }
+            if (pET) { pET->ts[EXT_RTS_WRCFG_BGN]= now; }
+            pE->arc.cfgPB[1]= pR->cfgRB0[0]; // Sets Gain, Mux, flags (Single Shot & Start)
+            r= lxi2cWriteRB(pE->arc.pC, pE->arc.busAddr, pE->arc.cfgPB, ADS1X_NRB);
+            timeSetTarget(&(pS->due), &now, pE->arc.ivlNanoSec[0], TIME_MODE_NOW);
+            if (pET) { pET->ts[EXT_RTS_WRCFG_END]= now; }
+            if (r > 0)
+            {
+               pS->iTrans++;
+               pS->ev= MULTI_EV_READ;
+               continue;
+            }
+         }
+         else
+         {
+            r= lxi2cReadRB(pE->arc.pC, pE->arc.busAddr, resPB, ADS1X_NRB);
+            if (pET)
+            {
+               pET->ts[EXT_RTS_RDVAL_BGN]= now;
+               timeStamp(pET->ts+EXT_RTS_RDVAL_END);
+            }
+            if (r > 0)
+            {
+               pS->iTrans++;
+               pS->vr= rdI16BE(resPB+1);
+               if ((pS->vr < 0) && (pR->flSt & AGR_FLAG_SGND)) { pR->flSt|= AGR_FLAG_ORNG; }
+               else if (pR->flSt & AGR_FLAG_AUTO)
+               {
+                  if (pE->arc.pPG && !rangeFaultPG(pS->vr, pE->arc.fsr)) { more= 0; } // prediction adequate
+                  else { more= autoGainAGR(pR, pS->vr, &(pE->arc)) && (pS->iTrans < pE->arc.maxTrans); }
+               }
+            }
+         }
+         if (more)
+         {  // Immediate re-conversion
+            pS->ev= MULTI_EV_START;
+            timeStamp(&(pS->due));
+         }
+         else
+         {  // Channel complete (or failed): move on
+            if (r >= 0)
+            {
+               n+= statusAGR(pR, pS->vr, pS->iTrans, pE->arc.fsr);
+               updateGainHistAGR(pR, pE->arc.cfgPB+1, &(pE->arc), pS->iMux, pS->pred);
+            }
+            pS->vr= 0; pS->iTrans= 0;
+            if (++(pS->iMux) >= pE->arc.nMux) { pS->ev= MULTI_EV_NONE; }
+            else
+            {
+               pS->ev= MULTI_EV_START;
+               if (pE->arc.ivlNanoSec[1] > 0) { pS->due= pE->targetTS[1]; } else { timeStamp(&(pS->due)); }
+            }
+         }
+      }
+   } while (iD >= 0);
+   return(n);
+} // readMultiRawADS1x
@@ -6,25 +6,44 @@
 #ifndef ADS1X_AUTO_H
 #define ADS1X_AUTO_H
 
-#include "ads1xUtil.h"
-#include "lxI2C.h"
+#include "lxI2C.h" // NB: first, so that platform types (util.h) prevail over mbdDef.h
 #include "lxTiming.h"
+#include "ads1xUtil.h"
 
 
 /***/
 
 #define ADS1X_MUX_MAX 8
 
+// Per-channel reading history for predictive gain selection (values in volts)
+typedef struct
+{
+   F32   last, slope, var; // Most recent reading, smoothed change per scan & variance of change
+   U8    n;    // History length (saturating, reset by invalid reading)
+} ADSGainHist;
+
+typedef struct
+{
+   ADSGainHist h[ADS1X_MUX_MAX];
+   U32   nPred;   // Gain changes made ahead of conversion
+   U32   nSaved;  // ... of which required no re-conversion
+   U32   nReConv; // Readings requiring fallback re-conversion (range fault)
+} ADSPredGain;
+
 // Auto-gain raw reading group parameters
 typedef struct
 {
    const LXI2CBusCtx *pC;
+   ADSPredGain *pPG; // Optional predictive gain state (NULL for purely reactive auto-gain)
    long  ivlNanoSec[2]; // Conversion interval (hardware rate dependant 303usec~125msec. for 400kHz bus clock)
    I16   fsr;    // Full scale raw reading (value is hardware version dependant)
    U8    busAddr; // I2C device address
    U8    maxTrans;    // Max transactions per mux channel
    U8    nMux;
    U8    cfgPB[ADS1X_NRB]; // Config packet bytes
+   U8    cfgNext[ADS1X_MUX_MAX]; // Pipelined scan: config byte for next conversion of each channel
+   U8    maskNext;   // ... channels for which it is pending (auto-gain change deferred, or prediction)
+   U8    tsMask;     // Timing stamps wanted (bit per EXT_RTS_* below), others may be left unset
 } AutoRawCtx;
 
 #define AGR_FLAG_AUTO 1<<7 // Enable auto gain
@@ -47,6 +66,15 @@ typedef struct
    RawTimeStamp targetTS[2];
 } AutoExtCtx;
 
+// Devices per bus (address selected by pin strapping 0x48..0x4B)
+#define ADS1X_DEV_MAX 4
+
+typedef struct
+{
+   AutoExtCtx aec[ADS1X_DEV_MAX];
+   U8 nDev;
+} ADSMultiCtx;
+
 typedef struct
 {
    U16 rate[2]; // outer, inner
@@ -55,15 +83,34 @@ typedef struct
    //U8 cfg[ADS1X_NRB]; ? consider ?
    U8 maskAG;
    U8 timeEst; // Sample timing measure/estimation method
-   U8 modeFlags;
+   U16 modeFlags;
 } ADSReadParam;
 
+// ADSReadParam modeFlags: bits 4..7 reserved for test modes (see ads1xDev.h)
+#define ADS1X_MODE_PRED    (1<<8)   // Predictive gain selection (auto modes)
+#define ADS1X_MODE_MASK    (0x0F)   // Lower nybble mask applies to all
+#define ADS1X_MODE_CONT    (1<<3)   // Continuous conversion streaming (single channel)
+#define ADS1X_MODE_PIPE    (1<<2)   // Pipelined mux scan (fused read+config transactions)
+#define ADS1X_MODE_XTIMING (1<<1)   // Extended timing information
+#define ADS1X_MODE_VERBOSE (1<<0)   // Diagnostic info (to console)
+
+// Rate plan: predicted timing for a mux scan at selected data rate
+typedef struct
+{
+   long  convNS, transNS;  // Conversion interval (with tolerance) & bus transaction time (incl. overhead)
+   long  scanNS, spareNS;  // Predicted scan time & spare time per scan at required rate
+   F32   busUtil;          // Fraction of time bus in use (wire time only)
+   U16   scanRate;         // Required scan rate (Hz)
+   U8    rateID;
+} ADSRatePlan;
+
 #define EXT_RTS_COUNT (5)
 #define EXT_RTS_MUXCH_BGN (4)
 #define EXT_RTS_WRCFG_BGN (3)
 #define EXT_RTS_WRCFG_END (2)
 #define EXT_RTS_RDVAL_BGN (1)
 #define EXT_RTS_RDVAL_END (0)
+#define EXT_RTS_MASK_ALL ((1<<EXT_RTS_COUNT)-1)
 
 typedef struct {  // TODO: reverse order
    RawTimeStamp ts[EXT_RTS_COUNT]; // channel start plus begin-end for two transactions (setup & read)
@@ -77,9 +124,36 @@ extern F32 ads1xGainScaleV (const U8 cfg[1], const ADS1xHWID x);
 
 extern int readAutoRawADS1x (RawAGR agr[], ExtRawTiming *pT, int nR, RawTimeStamp *pTarget, AutoRawCtx *pARC);
 
+// As above but with result read & next config write fused into one transaction (gain changes deferred)
+extern int readPipeRawADS1x (RawAGR agr[], ExtRawTiming *pT, int nR, RawTimeStamp *pTarget, AutoRawCtx *pARC);
+
+// Continuous conversion streaming of a single channel: configure once then read result only
+extern int startContADS1x (const RawAGR *pR, AutoRawCtx *pARC);
+extern int readContRawADS1x (RawAGR agr[], RawTimeStamp ts[], int nR, RawTimeStamp *pTarget, AutoRawCtx *pARC, int *pErr);
+extern int stopContADS1x (AutoRawCtx *pARC);
+
+// Read device config register packet, updating data rate on device if required
+extern int ads1xSyncRate (U8 cfgPB[ADS1X_NRB], const LXI2CBusCtx *pC, const U8 busAddr, const enum ADS1xRate rateID);
+
+// Convert raw results to Volts (zero where invalid)
+extern int convertRawAGR (F32 f[], const RawAGR r[], const int n, const ADSInstProp *pP);
+
 extern U8 setupRawAGR (RawAGR r[], const U8 mux[], U8 n, const U8 maskAG, const enum ADS1xGain initGain);
 
+// Plan data rate and scan (outer/inner) rates for the mux channels of *pM, each
+// required at the rate given in chanRate[] (scan rate is the maximum), allowing
+// for the expected fraction of auto-gain re-conversions. Transaction time is
+// derived from the bus clock (Hz) plus a per-transaction (system call etc.) overhead.
+// The slowest (least noisy) feasible data rate is chosen and pM->rate[] set.
+// Returns 1 if feasible, 0 if not (fastest rate planned, spare time negative).
+extern int ads1xPlanRate (ADSRatePlan *pRP, ADSReadParam *pM, const U16 chanRate[], const F32 reconv, const int clk, const long ovhdNS, const ADS1xHWID hwID);
+
 extern int setupAEC (AutoExtCtx *pAEC, const ADSInstProp *pP, const ADSReadParam *pM, const U8 * pCfgPB, const LXI2CBusCtx *pC);
 
+// Interleaved reading of several devices sharing one bus: conversion waits overlap.
+// Optional timing (pT) requires an array per device (nDev pointers to nMux records).
+extern int setupMultiAEC (ADSMultiCtx *pMC, const ADSInstProp ip[], int nDev, const ADSReadParam *pM, const LXI2CBusCtx *pC);
+extern int readMultiRawADS1x (ADSMultiCtx *pMC, ExtRawTiming *pT[]);
+
 
 #endif // ADS1X_AUTO_H
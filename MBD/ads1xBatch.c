@@ -0,0 +1,188 @@
+// Common/MBD/ads1xBatch.c - batch conversion of raw results from TI I2C ADC devices (ADS1xxx series)
+// https://github.com/DrAl-HFS/Common.git
+// Licence: AGPL3
+// (c) Project Contributors Sept 2021
+
+#include "ads1xBatch.h"
+
+// Vector paths rely on RawAGR layout as a little-endian 32bit word:
+// result in bits 0..15, config byte (gain code at bit 17) in 16..23, status in 24..31
+#if (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ADS_BATCH_AVX2
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define ADS_BATCH_SSSE3
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define ADS_BATCH_NEON
+#endif
+#endif // LE
+
+#define AGR_SH_GAIN  (16 + ADS1X_SH0_GAIN)
+#define AGR_VROK_W   ((U32)(AGR_FLAG_VROK) << 24)
+
+
+/***/
+
+void ads1xInitScaleTab (ADSScaleTab *pT, const ADSInstProp *pP)
+{
+   const F32 rcpFSR= 1.0 / ads1xRawFSR(pP->hwID);
+   for (int i=0; i<=ADS1X_GAIN_M; i++) { pT->s[i]= ads1xGainToFSV(i) * rcpFSR; }
+} // ads1xInitScaleTab
+
+int ads1xInitResDivPat (ADSResDivPat *pP, const ADSResDiv *pRD, const int nMux, const ADSInstProp *pIP)
+{
+   int l= 8;
+   if ((nMux <= 0) || (nMux > ADS_RES_DIV_MAX)) { return(0); }
+   while (0 != (l % nMux)) { l+= 8; }
+   for (int i=0; i<l; i++) { pP->r[i]= adsResDivValue(pRD, i % nMux); }
+   pP->vdd= pIP->vdd;
+   pP->len= l;
+   return(l);
+} // ads1xInitResDivPat
+
+// Scalar conversion of records [i0, n)
+static void convScalar (F32 v[], F32 res[], const RawAGR r[], int i0, const int n, const ADSScaleTab *pT, const ADSResDivPat *pP)
+{
+   for (int i=i0; i<n; i++)
+   {
+      if (r[i].flSt & AGR_FLAG_VROK) { v[i]= r[i].res * pT->s[ ads1xGetGain(r[i].cfgRB0) ]; } else { v[i]= 0; }
+      if (res) { res[i]= pP->r[i % pP->len] * v[i] * rcpF(pP->vdd - v[i]); }
+   }
+} // convScalar
+
+#ifdef ADS_BATCH_AVX2
+static int convAVX2 (F32 v[], F32 res[], const RawAGR r[], const int n, const ADSScaleTab *pT, const ADSResDivPat *pP)
+{
+   const __m256 tab= _mm256_load_ps(pT->s);
+   const __m256i mG= _mm256_set1_epi32(ADS1X_GAIN_M), mOK= _mm256_set1_epi32(AGR_VROK_W);
+   const __m256 vdd= _mm256_set1_ps(res ? pP->vdd : 0);
+   int i, k= 0;
+   for (i= 0; i <= (n-8); i+= 8)
+   {
+      const __m256i x= _mm256_loadu_si256((const __m256i*)(r+i));
+      const __m256i raw= _mm256_srai_epi32(_mm256_slli_epi32(x, 16), 16); // sign extend
+      const __m256i g= _mm256_and_si256(_mm256_srli_epi32(x, AGR_SH_GAIN), mG);
+      const __m256i ok= _mm256_cmpeq_epi32(_mm256_and_si256(x, mOK), mOK);
+      __m256 f= _mm256_mul_ps(_mm256_cvtepi32_ps(raw), _mm256_permutevar8x32_ps(tab, g));
+      f= _mm256_and_ps(f, _mm256_castsi256_ps(ok));
+      _mm256_storeu_ps(v+i, f);
+      if (res)
+      {
+         __m256 d= _mm256_sub_ps(vdd, f);
+         __m256 q= _mm256_div_ps(_mm256_mul_ps(_mm256_loadu_ps(pP->r+k), f), d);
+         q= _mm256_and_ps(q, _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_NEQ_OQ)); // as rcpF(0)
+         _mm256_storeu_ps(res+i, q);
+         k+= 8; if (k >= pP->len) { k= 0; }
+      }
+   }
+   return(i);
+} // convAVX2
+#endif // ADS_BATCH_AVX2
+
+#ifdef ADS_BATCH_SSSE3
+static int convSSSE3 (F32 v[], F32 res[], const RawAGR r[], const int n, const ADSScaleTab *pT, const ADSResDivPat *pP)
+{
+   const __m128i tabL= _mm_load_si128((const __m128i*)(pT->s+0)), tabH= _mm_load_si128((const __m128i*)(pT->s+4));
+   const __m128i m3= _mm_set1_epi32(0x3), m4= _mm_set1_epi32(0x4), mOK= _mm_set1_epi32(AGR_VROK_W);
+   const __m128i byteOffs= _mm_set1_epi32(0x03020100);
+   const __m128 vdd= _mm_set1_ps(res ? pP->vdd : 0);
+   int i, k= 0;
+   for (i= 0; i <= (n-4); i+= 4)
+   {
+      const __m128i x= _mm_loadu_si128((const __m128i*)(r+i));
+      const __m128i raw= _mm_srai_epi32(_mm_slli_epi32(x, 16), 16); // sign extend
+      const __m128i g= _mm_srli_epi32(x, AGR_SH_GAIN);
+      __m128i b= _mm_slli_epi32(_mm_and_si128(g, m3), 2); // byte index of table word (within half)
+      b= _mm_or_si128(b, _mm_slli_epi32(b, 8));
+      b= _mm_add_epi8(_mm_or_si128(b, _mm_slli_epi32(b, 16)), byteOffs);
+      const __m128i hi= _mm_cmpeq_epi32(_mm_and_si128(g, m4), m4);
+      const __m128i s= _mm_or_si128(_mm_and_si128(hi, _mm_shuffle_epi8(tabH, b)), _mm_andnot_si128(hi, _mm_shuffle_epi8(tabL, b)));
+      const __m128i ok= _mm_cmpeq_epi32(_mm_and_si128(x, mOK), mOK);
+      __m128 f= _mm_mul_ps(_mm_cvtepi32_ps(raw), _mm_castsi128_ps(s));
+      f= _mm_and_ps(f, _mm_castsi128_ps(ok));
+      _mm_storeu_ps(v+i, f);
+      if (res)
+      {
+         __m128 d= _mm_sub_ps(vdd, f);
+         __m128 q= _mm_div_ps(_mm_mul_ps(_mm_loadu_ps(pP->r+k), f), d);
+         q= _mm_and_ps(q, _mm_cmpneq_ps(d, _mm_setzero_ps())); // as rcpF(0)
+         _mm_storeu_ps(res+i, q);
+         k+= 4; if (k >= pP->len) { k= 0; }
+      }
+   }
+   return(i);
+} // convSSSE3
+#endif // ADS_BATCH_SSSE3
+
+#ifdef ADS_BATCH_NEON
+static int convNEON (F32 v[], F32 res[], const RawAGR r[], const int n, const ADSScaleTab *pT, const ADSResDivPat *pP)
+{
+   const uint8x16x2_t tab= { { vld1q_u8((const U8*)(pT->s+0)), vld1q_u8((const U8*)(pT->s+4)) } };
+   const uint32x4_t mG= vdupq_n_u32(ADS1X_GAIN_M), mOK= vdupq_n_u32(AGR_VROK_W);
+   const uint32x4_t byteOffs= vdupq_n_u32(0x03020100);
+   const float32x4_t vdd= vdupq_n_f32(res ? pP->vdd : 0);
+   int i, k= 0;
+   for (i= 0; i <= (n-4); i+= 4)
+   {
+      const uint32x4_t x= vld1q_u32((const uint32_t*)(r+i));
+      const int32x4_t raw= vshrq_n_s32(vshlq_n_s32(vreinterpretq_s32_u32(x), 16), 16); // sign extend
+      const uint32x4_t g= vandq_u32(vshrq_n_u32(x, AGR_SH_GAIN), mG);
+      const uint32x4_t b= vmlaq_n_u32(byteOffs, vshlq_n_u32(g, 2), 0x01010101); // byte index of table word
+      const float32x4_t s= vreinterpretq_f32_u8(vqtbl2q_u8(tab, vreinterpretq_u8_u32(b)));
+      const uint32x4_t ok= vceqq_u32(vandq_u32(x, mOK), mOK);
+      float32x4_t f= vmulq_f32(vcvtq_f32_s32(raw), s);
+      f= vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(f), ok));
+      vst1q_f32(v+i, f);
+      if (res)
+      {
+         const float32x4_t d= vsubq_f32(vdd, f);
+         float32x4_t q= vdivq_f32(vmulq_f32(vld1q_f32(pP->r+k), f), d);
+         q= vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(q), vceqzq_f32(d))); // as rcpF(0)
+         vst1q_f32(res+i, q);
+         k+= 4; if (k >= pP->len) { k= 0; }
+      }
+   }
+   return(i);
+} // convNEON
+#endif // ADS_BATCH_NEON
+
+static int convBatch (F32 v[], F32 res[], const RawAGR r[], const int n, const ADSScaleTab *pT, const ADSResDivPat *pP)
+{
+   int i= 0;
+#if defined(ADS_BATCH_AVX2)
+   i= convAVX2(v, res, r, n, pT, pP);
+#elif defined(ADS_BATCH_SSSE3)
+   i= convSSSE3(v, res, r, n, pT, pP);
+#elif defined(ADS_BATCH_NEON)
+   i= convNEON(v, res, r, n, pT, pP);
+#endif
+   convScalar(v, res, r, i, n, pT, pP); // remainder
+   return(n);
+} // convBatch
+
+
+/***/
+
+int ads1xConvertBatch (F32 v[], const RawAGR r[], const int n, const ADSScaleTab *pT)
+{
+   return convBatch(v, NULL, r, n, pT, NULL);
+} // ads1xConvertBatch
+
+int ads1xConvertCols (F32 v[], const I16 res[], const U8 gain[], const U8 flSt[], const int n, const ADSScaleTab *pT)
+{
+   for (int i=0; i<n; i++)
+   {
+      const F32 f= res[i] * pT->s[ gain[i] & ADS1X_GAIN_M ];
+      v[i]= (flSt[i] & AGR_FLAG_VROK) ? f : 0;
+   }
+   return(n);
+} // ads1xConvertCols
+
+int ads1xResDivBatch (F32 v[], F32 res[], const RawAGR r[], const int n, const ADSScaleTab *pT, const ADSResDivPat *pP)
+{
+   if ((NULL == pP) || (pP->len <= 0)) { return(-1); }
+   return convBatch(v, res, r, n, pT, pP);
+} // ads1xResDivBatch
@@ -0,0 +1,50 @@
+// Common/MBD/ads1xBatch.h - batch conversion of raw results from TI I2C ADC devices (ADS1xxx series)
+// https://github.com/DrAl-HFS/Common.git
+// Licence: AGPL3
+// (c) Project Contributors Sept 2021
+
+#ifndef ADS1X_BATCH_H
+#define ADS1X_BATCH_H
+
+#include "ads1xAuto.h"
+
+
+/***/
+
+// Volts per raw unit for each 3bit gain code (codes 5..7 all select 0.256V)
+typedef struct
+{
+   F32 s[ADS1X_GAIN_M+1];
+} __attribute__((aligned(32))) ADSScaleTab;
+
+// Resistance (Ohms) of divider fixed element repeated to a multiple of 8
+// records, allowing vector access at any aligned record position.
+#define ADS1X_RDP_MAX (24) // lcm(8, 1..ADS_RES_DIV_MAX)
+typedef struct
+{
+   F32 r[ADS1X_RDP_MAX];
+   F32 vdd;
+   int len;
+} __attribute__((aligned(32))) ADSResDivPat;
+
+
+/***/
+
+extern void ads1xInitScaleTab (ADSScaleTab *pT, const ADSInstProp *pP);
+
+// Setup for mux scans of nMux channels (interleaved records)
+extern int ads1xInitResDivPat (ADSResDivPat *pP, const ADSResDiv *pRD, const int nMux, const ADSInstProp *pIP);
+
+// Equivalent to convertRawAGR() but vectorised (AVX2, SSSE3 or NEON where
+// available at compile time, otherwise scalar) for large blocks of records.
+extern int ads1xConvertBatch (F32 v[], const RawAGR r[], const int n, const ADSScaleTab *pT);
+
+// Columnar equivalent (e.g. capture blocks): result, gain code & status in separate
+// arrays. Plain scalar loop, being readily vectorised by the compiler.
+extern int ads1xConvertCols (F32 v[], const I16 res[], const U8 gain[], const U8 flSt[], const int n, const ADSScaleTab *pT);
+
+// As above plus resistance (Ohms) of sensor element as adsGetResDiv(), in the same pass.
+// Record 0 is assumed to be the first mux channel of a scan.
+extern int ads1xResDivBatch (F32 v[], F32 res[], const RawAGR r[], const int n, const ADSScaleTab *pT, const ADSResDivPat *pP);
+
+#endif // ADS1X_BATCH_H
@@ -0,0 +1,175 @@
+// Common/MBD/ads1xCapt.c - binary capture of sample streams from TI I2C ADC devices (ADS1xxx series)
+// https://github.com/DrAl-HFS/Common.git
+// Licence: AGPL3
+// (c) Project Contributors Sept 2021
+
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "ads1xCapt.h"
+
+
+/***/
+
+#ifndef INLINE
+const I16 *adsCaptRes (const ADSCaptBlk *pB, const U32 blkRec) { return (const I16 *)(pB->tNS + blkRec); }
+const U8 *adsCaptGain (const ADSCaptBlk *pB, const U32 blkRec) { return (const U8 *)(adsCaptRes(pB, blkRec) + blkRec); }
+const U8 *adsCaptStatus (const ADSCaptBlk *pB, const U32 blkRec) { return(adsCaptGain(pB, blkRec) + blkRec); }
+U64 adsCaptNS (const RawTimeStamp *pT) { return timeNS(pT); }
+#endif
+
+// Header size rounded up so that block columns are naturally aligned
+static U32 captHdrBytes (void) { return((sizeof(ADSCaptHdr) + 0x3F) & ~0x3F); }
+
+static U32 captBlkBytes (const U32 blkRec) { return(sizeof(ADSCaptBlk) + blkRec * ADS1X_CAPT_REC_BYTES); }
+
+static int captFlush (ADSCaptWriter *pW)
+{
+   if (pW->pB->nRec > 0)
+   {
+      const U32 nRec= pW->pB->nRec;
+      if (nRec < pW->blkRec)
+      {  // pad partial block (every column)
+         U8 *pC= (U8*)(pW->pB->tNS + pW->blkRec);
+         const U32 nPad= pW->blkRec - nRec;
+         memset(pW->pB->tNS + nRec, 0, nPad * sizeof(U64));
+         memset(pC + nRec * sizeof(I16), 0, nPad * sizeof(I16));
+         pC+= pW->blkRec * sizeof(I16);
+         memset(pC + nRec, 0, nPad);
+         pC+= pW->blkRec;
+         memset(pC + nRec, 0, nPad);
+      }
+      if (1 != fwrite(pW->pB, pW->blkBytes, 1, pW->pF)) { ERROR_CALL("() - fwrite() fail, block %u\n", pW->nBlk); return(-1); }
+      fflush(pW->pF);
+      pW->pB->iBlk= ++(pW->nBlk);
+      pW->pB->nRec= 0;
+      return(1);
+   }
+   return(0);
+} // captFlush
+
+
+/***/
+
+int adsCaptOpen (ADSCaptWriter *pW, const char *path, const ADSInstProp *pP, const ADSReadParam *pM, const RawTimeStamp *pRefTS)
+{
+   const U32 hdrBytes= captHdrBytes();
+   U8 hb[hdrBytes];
+   ADSCaptHdr *pH= (void*)hb;
+
+   memset(pW, 0, sizeof(*pW));
+   if ((pM->nMux <= 0) || (pM->nMux > ADS1X_MUX_MAX)) { return(-1); }
+
+   memset(hb, 0, hdrBytes);
+   memcpy(pH->magic, ADS1X_CAPT_MAGIC, sizeof(pH->magic));
+   pH->ver= ADS1X_CAPT_VER;
+   pH->hdrBytes= hdrBytes;
+   pH->blkRec= ADS1X_CAPT_SCANS * pM->nMux;
+   pH->blkBytes= captBlkBytes(pH->blkRec);
+   if (pRefTS) { pH->refNS= adsCaptNS(pRefTS); }
+   pH->inst= *pP;
+   pH->param= *pM;
+   pH->nMux= pM->nMux;
+   memcpy(pH->muxMap, pM->mux, pM->nMux);
+
+   pW->pB= malloc(pH->blkBytes);
+   if (NULL == pW->pB) { return(-1); }
+   pW->pF= fopen(path, "wb");
+   if (pW->pF && (1 == fwrite(hb, hdrBytes, 1, pW->pF)))
+   {
+      pW->blkRec= pH->blkRec;
+      pW->blkBytes= pH->blkBytes;
+      pW->pB->nRec= 0;
+      pW->pB->iBlk= 0;
+      return(1);
+   }
+   ERROR_CALL("(.. %s ..) - failed\n", path);
+   adsCaptClose(pW);
+   return(-1);
+} // adsCaptOpen
+
+int adsCaptAdd (ADSCaptWriter *pW, const RawAGR agr[], const RawTimeStamp *pTS, const int tsStride, const int n)
+{
+   int i= 0;
+   if (NULL == pW->pF) { return(0); }
+   while (i < n)
+   {
+      ADSCaptBlk *pB= pW->pB;
+      I16 *pR= (I16*)adsCaptRes(pB, pW->blkRec) + pB->nRec;
+      U8 *pG= (U8*)adsCaptGain(pB, pW->blkRec) + pB->nRec;
+      U8 *pS= (U8*)adsCaptStatus(pB, pW->blkRec) + pB->nRec;
+      const int m= MIN(n - i, (int)(pW->blkRec - pB->nRec));
+      for (int j=0; j<m; j++)
+      {
+         const int k= i + j;
+         pB->tNS[pB->nRec + j]= adsCaptNS(pTS + k * tsStride);
+         pR[j]= agr[k].res;
+         pG[j]= ads1xGetGain(agr[k].cfgRB0);
+         pS[j]= agr[k].flSt;
+      }
+      pB->nRec+= m;
+      i+= m;
+      if ((pB->nRec >= pW->blkRec) && (captFlush(pW) < 0)) { break; }
+   }
+   return(i);
+} // adsCaptAdd
+
+int adsCaptClose (ADSCaptWriter *pW)
+{
+   if (pW->pF)
+   {
+      captFlush(pW);
+      fclose(pW->pF);
+      pW->pF= NULL;
+   }
+   if (pW->pB) { free(pW->pB); pW->pB= NULL; }
+   return(pW->nBlk);
+} // adsCaptClose
+
+
+/***/
+
+int adsCaptMap (ADSCaptMap *pM, const char *path)
+{
+   const size_t bytes= fileSize(path);
+   const ADSCaptHdr *pH;
+   void *p;
+   int fd;
+
+   memset(pM, 0, sizeof(*pM));
+   if (bytes < sizeof(ADSCaptHdr)) { return(-1); }
+   fd= open(path, O_RDONLY);
+   if (fd < 0) { ERROR_CALL("(.. %s) - open() fail\n", path); return(-1); }
+   p= mmap(NULL, bytes, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd); // mapping persists
+   if (MAP_FAILED == p) { ERROR_CALL("(.. %s) - mmap() fail\n", path); return(-1); }
+
+   pH= p;
+   if ((0 != memcmp(pH->magic, ADS1X_CAPT_MAGIC, sizeof(pH->magic))) || (ADS1X_CAPT_VER != pH->ver) ||
+      (pH->hdrBytes < sizeof(ADSCaptHdr)) || (pH->hdrBytes > bytes) ||
+      (pH->nMux <= 0) || (pH->nMux > ADS1X_MUX_MAX) || (pH->blkRec <= 0) || (0 != (pH->blkRec % pH->nMux)) ||
+      (pH->blkRec > (bytes / ADS1X_CAPT_REC_BYTES)) || (pH->blkBytes != captBlkBytes(pH->blkRec)))
+   {  // NB: block size bounded by file size before computing (avoid overflow)
+      ERROR_CALL("(.. %s) - unrecognised format or corrupt header\n", path);
+      munmap(p, bytes);
+      return(-1);
+   }
+   madvise(p, bytes, MADV_SEQUENTIAL);
+   pM->pH= pH;
+   pM->pB= (const U8*)p + pH->hdrBytes;
+   pM->bytes= bytes;
+   pM->nBlk= (bytes - pH->hdrBytes) / pH->blkBytes; // NB: ignore incomplete trailing block
+   return(pM->nBlk);
+} // adsCaptMap
+
+const ADSCaptBlk *adsCaptBlk (const ADSCaptMap *pM, const U32 iBlk)
+{
+   if (iBlk < pM->nBlk) { return (const ADSCaptBlk *)(pM->pB + (size_t)iBlk * pM->pH->blkBytes); }
+   return(NULL);
+} // adsCaptBlk
+
+void adsCaptUnmap (ADSCaptMap *pM)
+{
+   if (pM->pH) { munmap((void*)(pM->pH), pM->bytes); }
+   memset(pM, 0, sizeof(*pM));
+} // adsCaptUnmap
@@ -0,0 +1,91 @@
+// Common/MBD/ads1xCapt.h - binary capture of sample streams from TI I2C ADC devices (ADS1xxx series)
+// https://github.com/DrAl-HFS/Common.git
+// Licence: AGPL3
+// (c) Project Contributors Sept 2021
+
+#ifndef ADS1X_CAPT_H
+#define ADS1X_CAPT_H
+
+#include "ads1xAuto.h"
+
+
+/***/
+
+// File layout: header then fixed size blocks, each holding four columns:
+// 64bit nanosecond timestamp, int16 raw result, 3bit gain code (byte) and
+// status (RawAGR flSt, byte). The mux setting of each record follows from its
+// position within the scan (see muxMap). Native byte order and structure
+// layout are used throughout, so files are portable only between similar hosts.
+// Blocks are appended whole: a partial final block is padded & its record
+// count set accordingly. Block size is a whole number of mux scans (and a
+// multiple of 64 records, so every column remains naturally aligned).
+#define ADS1X_CAPT_MAGIC   "ADSC"
+#define ADS1X_CAPT_VER     (3)  // 2: ADSReadParam.modeFlags widened, 3: separate result, gain & status columns
+#define ADS1X_CAPT_SCANS   (64) // Mux scans per block
+#define ADS1X_CAPT_REC_BYTES  (sizeof(U64) + sizeof(I16) + 2 * sizeof(U8))
+
+typedef struct
+{
+   char  magic[4];
+   U16   ver, hdrBytes;
+   U32   blkRec, blkBytes;    // Records & bytes per block
+   U64   refNS;               // Capture start (CLOCK_REALTIME)
+   ADSInstProp    inst;
+   ADSReadParam   param;
+   U8    nMux, muxMap[ADS1X_MUX_MAX]; // Mux setting of each record position within scan
+} ADSCaptHdr;
+
+typedef struct
+{
+   U32   nRec, iBlk;
+   U64   tNS[];   // timestamp column, followed by result, gain & status columns (see adsCaptRes() etc.)
+} ADSCaptBlk;
+
+typedef struct
+{
+   FILE  *pF;
+   ADSCaptBlk *pB;   // Current block
+   U32   blkRec, blkBytes, nBlk;
+} ADSCaptWriter;
+
+typedef struct
+{
+   const ADSCaptHdr *pH;
+   const U8 *pB;     // First block
+   size_t   bytes;   // Total mapped
+   U32      nBlk;
+} ADSCaptMap;
+
+
+/***/
+
+// Column access for a block of blkRec records
+#ifndef INLINE
+extern const I16 *adsCaptRes (const ADSCaptBlk *pB, const U32 blkRec);
+extern const U8 *adsCaptGain (const ADSCaptBlk *pB, const U32 blkRec);
+extern const U8 *adsCaptStatus (const ADSCaptBlk *pB, const U32 blkRec);
+extern U64 adsCaptNS (const RawTimeStamp *pT);
+#else
+INLINE const I16 *adsCaptRes (const ADSCaptBlk *pB, const U32 blkRec) { return (const I16 *)(pB->tNS + blkRec); }
+INLINE const U8 *adsCaptGain (const ADSCaptBlk *pB, const U32 blkRec) { return (const U8 *)(adsCaptRes(pB, blkRec) + blkRec); }
+INLINE const U8 *adsCaptStatus (const ADSCaptBlk *pB, const U32 blkRec) { return(adsCaptGain(pB, blkRec) + blkRec); }
+INLINE U64 adsCaptNS (const RawTimeStamp *pT) { return timeNS(pT); }
+#endif
+
+// Create capture file (existing content discarded) and write header. Returns >0 on success.
+extern int adsCaptOpen (ADSCaptWriter *pW, const char *path, const ADSInstProp *pP, const ADSReadParam *pM, const RawTimeStamp *pRefTS);
+
+// Append n records, timestamps taken from pTS with given stride (in RawTimeStamp units).
+// Each completed block is written immediately. Returns number of records added.
+extern int adsCaptAdd (ADSCaptWriter *pW, const RawAGR agr[], const RawTimeStamp *pTS, const int tsStride, const int n);
+
+// Write any partial block and close file. Returns total blocks written.
+extern int adsCaptClose (ADSCaptWriter *pW);
+
+// Map capture file (read only) for zero-copy access. Returns block count or <0 on error.
+extern int adsCaptMap (ADSCaptMap *pM, const char *path);
+// NB: block record count (nRec) is as found in file, clamp to header blkRec before use
+extern const ADSCaptBlk *adsCaptBlk (const ADSCaptMap *pM, const U32 iBlk);
+extern void adsCaptUnmap (ADSCaptMap *pM);
+
+#endif // ADS1X_CAPT_H
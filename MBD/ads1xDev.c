@@ -4,7 +4,14 @@
 // (c) Project Contributors Sept 2020
 
 #include "ads1xDev.h"
-//#include "ads1xAuto.h"
+#include "ads1xTxtIF.h"
+#include "ads1xCapt.h"
+#include "ads1xBatch.h"
+#include "ads1xWatch.h"
+#include "firDecim.h"
+#include "lxRetry.h"
+#include <errno.h>
+#include <float.h>
 
 
 /***/
@@ -37,12 +44,6 @@ void ads1xTransCfg (ADS1xTrans *pT, const U8 cfg[2], const ADS1xHWID id)
 //char muxCh (const U8 c) { if (c<=3) return('0'+c); else return('G'); }
 //void RawAGR (const U8 m4x4) { printf("%c/%c", muxCh(m4x4 >> 4), muxCh(m4x4 & 0xF)); }
 
-const char * ads1xMuxStr (const enum ADS1xMux m)
-{
-   static const char* muxStr[]= {"0/1", "0/3", "1/3", "2/3", "0/G", "1/G", "2/G", "3/G"};
-   return muxStr[ m ];
-} // ads1xMuxStr
-
 void ads1xDumpCfg (const U8 cfg[2], const ADS1xHWID id)
 {
    ADS1xTrans t;
@@ -74,40 +75,107 @@ int idxMaxNU16 (const U16 u[], int n)
 } // idxMaxNU16
 
 /***/
-// Special extended values used to generate estimator parameters
-#define EXT_RTS_GEP01  (5) // EXT_RTS_RDVAL_END -> EXT_RTS_RDVAL_BGN
-#define EXT_RTS_GEP02  (6) // EXT_RTS_RDVAL_END -> EXT_RTS_WRCFG_END
-#define EXT_RTS_GEP03  (7) // EXT_RTS_RDVAL_END -> EXT_RTS_WRCFG_BGN
-#define EXT_RTS_GEP_BITS   (3)
-#define EXT_RTS_GEP_MASK   ((1<<EXT_RTS_GEP_BITS)-1)
-#define EXT_RTS_VAL_SHIFT  EXT_RTS_GEP_BITS
+
+// Sample time estimation: a conversion starts as its config write completes and
+// has finished by the time the result read begins, so the sample instant is taken
+// as write completion plus half the conversion latency (write end -> read begin).
+// Read stamps carry spin-wait overrun & scheduling jitter, so the latency is a
+// least-squares estimate (window mean) over recent observed write/read stamp pairs.
+// Latency depends only on data rate & bus clock, so learned state is kept per
+// (rateID, clk) pair and persists between acquisitions. Samples disagreeing with
+// the fit are reported with greater uncertainty.
+// NB: learned state is shared, not thread safe.
+#define ADS1X_TIME_LAT_WIN  (32)
+#define ADS1X_TIME_LAT_KEYS (4)
 
 typedef struct
 {
-   U8 idx[2], pad[2];
-   F32 r[2];
-} EstimatorRTS;
+   int   clk;     // Bus clock (Hz)
+   U8    rateID;  // Device data rate
+   U16   n, iW;   // Window fill count & write index
+   U32   k;       // Observations made
+   F64   d[ADS1X_TIME_LAT_WIN]; // Latency observations (seconds), circular
+   F64   mean, s2;   // Fit: latency & residual variance
+} ADSLatFit;
+
+typedef struct
+{
+   ADSLatFit *pLF;
+   F64 sumSD;  // Sum of uncertainty (for reporting)
+   F32 maxSD;
+   U32 nSD;
+} ADSTimeEst;
+
+static ADSLatFit gLatFit[ADS1X_TIME_LAT_KEYS];
+static U8 gLatFitNext= 0;
 
-EstimatorRTS *getTimeEstimator (U8 timeEst)
+// Find learned state for (rateID, clk), or recycle the oldest entry
+static ADSLatFit *getLatFit (const U8 rateID, const int clk)
 {
-static EstimatorRTS e; // Haaack!!!
-   EstimatorRTS *pE= NULL;
-   if (timeEst >= EXT_RTS_COUNT)
+   ADSLatFit *pF;
+   for (int i=0; i<ADS1X_TIME_LAT_KEYS; i++)
    {
-      pE= &e;
-      pE->idx[1]= EXT_RTS_RDVAL_END;
-      switch(timeEst & EXT_RTS_GEP_MASK)
-      {
-         case EXT_RTS_GEP01 : pE->idx[0]= EXT_RTS_RDVAL_BGN; break;
-         case EXT_RTS_GEP02 : pE->idx[0]= EXT_RTS_WRCFG_END; break;
-         case EXT_RTS_GEP03 : pE->idx[0]= EXT_RTS_WRCFG_BGN; break;
-      }
-      pE->r[1]=   0.02 + ((timeEst >> EXT_RTS_VAL_SHIFT) + 1) * 0.96 / (1<<(8-EXT_RTS_VAL_SHIFT));
-      pE->r[0]=   1.0 - pE->r[1];
-      LOG_CALL("(%d) -> %d, %d, %G, %G\n", timeEst, pE->idx[0], pE->idx[1], pE->r[0], pE->r[1]);
+      pF= gLatFit+i;
+      if ((pF->k > 0) && (pF->rateID == rateID) && (pF->clk == clk)) { return(pF); }
+   }
+   pF= gLatFit + gLatFitNext;
+   if (++gLatFitNext >= ADS1X_TIME_LAT_KEYS) { gLatFitNext= 0; }
+   memset(pF, 0, sizeof(*pF));
+   pF->rateID= rateID;
+   pF->clk= clk;
+   return(pF);
+} // getLatFit
+
+static void latFitAdd (ADSLatFit *pF, const F64 d)
+{
+   F64 m= 0, sRR= 0;
+
+   pF->k++;
+   pF->d[pF->iW]= d;
+   if (++(pF->iW) >= ADS1X_TIME_LAT_WIN) { pF->iW= 0; }
+   if (pF->n < ADS1X_TIME_LAT_WIN) { pF->n++; }
+   for (int i=0; i<pF->n; i++) { m+= pF->d[i]; }
+   m/= pF->n;
+   for (int i=0; i<pF->n; i++) { const F64 r= pF->d[i] - m; sRR+= r * r; }
+   pF->mean= m;
+   pF->s2= (pF->n > 1) ? sRR / (pF->n - 1) : 0;
+} // latFitAdd
+
+void setupTimeEst (ADSTimeEst *pE, const U8 rateID, const int clk)
+{
+   pE->pLF= getLatFit(rateID, clk);
+   pE->sumSD= 0;
+   pE->maxSD= 0;
+   pE->nSD= 0;
+} // setupTimeEst
+
+int elapsedFitRTS
+(
+   F32   f[],
+   F32   sd[], // uncertainty (optional)
+   const int   nF,
+   const ExtRawTiming   t[],
+   const RawTimeStamp   *pRef,
+   ADSTimeEst  *pE
+)
+{
+   ADSLatFit *pF= pE->pLF;
+   for (int i=0; i<nF; i++)
+   {
+      const RawTimeStamp *pW= t[i].ts+EXT_RTS_WRCFG_END;
+      const F64 d= 1E-9 * timeDiffNS(pW, t[i].ts+EXT_RTS_RDVAL_BGN);
+      latFitAdd(pF, d);
+      // Uncertainty of half latency: fit error plus this sample's disagreement
+      const F64 e= d - pF->mean;
+      const F32 s= 0.5 * sqrt(pF->s2 / pF->n + e * e);
+      f[i]= 1E-9 * timeDiffNS(pRef, pW) + 0.5 * pF->mean;
+      if (sd) { sd[i]= s; }
+      pE->sumSD+= s;
+      if (s > pE->maxSD) { pE->maxSD= s; }
+      pE->nSD++;
    }
-   return(pE);
-} // getTimeEstimator
+   return(nF);
+} // elapsedFitRTS
 
 /*
 U8 packTE (U8 ta, U8 tb, F32 f)
@@ -122,19 +190,6 @@ U8 packTE (U8 ta, U8 tb, F32 f)
 */
 
 
-// DISPLACE : ads1xUtil ?
-
-
-int convertRawAGR (F32 f[], const RawAGR r[], const int n, const ADSInstProp *pP)
-{
-   for (int i=0; i<n; i++)
-   {
-      if (r[i].flSt & AGR_FLAG_VROK) { f[i]= r[i].res * ads1xGainScaleV(r[i].cfgRB0, pP->hwID); }
-      else { f[i]= 0; }
-   }
-   return(n);
-} // convertRawAGR
-
 int elapsedStrideRTS
 (
    F32   f[],
@@ -148,23 +203,6 @@ int elapsedStrideRTS
    return(nF);
 } // elapsedStrideRTS
 
-int elapsedEstStrideRTS
-(
-   F32   f[],
-   const int   nF,
-   const RawTimeStamp   rawTS[],
-   const int   stride,
-   const RawTimeStamp   *pRef,
-   const EstimatorRTS   *pEst
-)
-{
-   for (int i=0; i<nF; i++)
-   {
-      f[i]= timeEstDiff(pRef, rawTS + pEst->idx[0] + i * stride, rawTS + pEst->idx[1] + i * stride, pEst->r);
-   }
-   return(nF);
-} // elapsedStrideRTS
-
 int elapsedTrnStrdRTS
 (
    F32   f[],
@@ -202,24 +240,60 @@ void reportStat (F32 x[3], F32 timeScale, F32 dof)
    report(LOG0,"Transaction mean, stdev : %G, %G, D=%G\n", sr.m, s, s * rcpF(sr.m));
 }
 
-void analyseInterval (const F32 t[], const int nM, const int nN)
+// Accumulate mux channel inter-sample interval statistics
+void addInterval (StatMomD1R2 *pS, const F32 t[], const int nM, const int nN)
 {
-   StatMomD1R2 sm={0,};
-   StatResD1R2 sr;
    for (int i=0; i<nM; i++)
    {
       for (int j=1; j<nN; j++)
       {
          int k= i + j * nM;
          F32 dt= t[k] - t[k-nM];
-         sm.m[1]+= dt;
-         sm.m[2]+= dt * dt;
+         pS->m[1]+= dt;
+         pS->m[2]+= dt * dt;
       }
    }
-   sm.m[0]= (nN-1) * nM;
-   statMom1Res1(&sr, &sm, sm.m[0]-1);
+   if (nN > 1) { pS->m[0]+= (nN-1) * nM; }
+} // addInterval
+
+// As above for nanosecond timestamps (captured data)
+// As addInterval() for nanosecond timestamps, continuing from the last time of
+// each channel in tLast[] (0 -> none) which is updated, so that intervals
+// spanning successive blocks are included.
+void addIntervalNS (StatMomD1R2 *pS, U64 tLast[], const U64 t[], const int nM, const int nN)
+{
+   for (int i=0; i<nM; i++)
+   {
+      U64 tP= tLast[i];
+      for (int j=0; j<nN; j++)
+      {
+         const U64 tK= t[i + j * nM];
+         if (tP > 0)
+         {
+            const F32 dt= (I64)(tK - tP) * (1.0 / NANO_TICKS);
+            pS->m[0]+= 1;
+            pS->m[1]+= dt;
+            pS->m[2]+= dt * dt;
+         }
+         tP= tK;
+      }
+      tLast[i]= tP;
+   }
+} // addIntervalNS
+
+void reportInterval (const StatMomD1R2 *pS)
+{
+   StatResD1R2 sr;
+   statMom1Res1(&sr, pS, pS->m[0]-1);
    F32 s= sqrt(sr.v), r= rcpF(sr.m);
    report(LOG0,"Mux channel inter-sample mean, stdev : %G, %G, D=%G, rate=%G\n", sr.m, s, s * r, r);
+} // reportInterval
+
+void analyseInterval (const F32 t[], const int nM, const int nN)
+{
+   StatMomD1R2 sm={0,};
+   addInterval(&sm, t, nM, nN);
+   reportInterval(&sm);
 } // analyseInterval
 
 
@@ -227,46 +301,81 @@ void analyseInterval (const F32 t[], const int nM, const int nN)
 
 static const char gSepCh[2]={'\t','\n'};
 
+static void validRawAGR (U8 vOK[], const RawAGR r[], const int n)
+{
+   for (int i=0; i<n; i++) { vOK[i]= (0 != (r[i].flSt & AGR_FLAG_VROK)); }
+} // validRawAGR
+
 int readAutoADS1X
 (
    F32        rV[],  // result Voltage
    F32        *pDT,  // result time difference from reference (optional)
+   F32        *pSD,  // uncertainty of time difference (optional, fitted timing only)
+   U8         vOK[], // result valid flags (optional)
    const int nMax,  // Max readings (over all MUX channels)
    const RawTimeStamp *pRefTS,
    U8 * pCfgPB,   // Optional device config register bytes (initial value modified)
    const LXI2CBusCtx *pC,
    const ADSInstProp *pP,
-   const ADSReadParam *pM
+   const ADSReadParam *pM,
+   ADSCaptWriter *pCW   // Optional binary capture
 )
 {
-   EstimatorRTS *pEstRTS=NULL;
+   ADSTimeEst te;
+   ADSTimeEst *pTE= NULL;
    ExtRawTiming extT[ADS1X_MUX_MAX], *pET=NULL;
    F32 sumTransDT[3]={0};  // StatMomD1R2 md1r2;
    AutoExtCtx aec;
+   ADSPredGain pg;
+   const U8 iTS= (pM->timeEst < EXT_RTS_COUNT) ? pM->timeEst : EXT_RTS_RDVAL_END; // captured
    int n=0, r=-1;
 
    if (nMax > 0)
    {
       r= setupAEC(&aec, pP, pM, pCfgPB, pC);
       if (r < 0) { return(r); }
-      pEstRTS= getTimeEstimator(pM->timeEst);
-      if (pDT || (pM->modeFlags & ADS1X_MODE_XTIMING))
+      if (pM->modeFlags & ADS1X_MODE_PRED)
+      {
+         memset(&pg, 0, sizeof(pg));
+         aec.arc.pPG= &pg;
+      }
+      if (pM->timeEst >= EXT_RTS_COUNT)
       {
+         setupTimeEst(&te, ads1xGetRate(aec.arc.cfgPB+1), pC->clk);
+         pTE= &te;
+      }
+      if (pDT || pCW || (pM->modeFlags & ADS1X_MODE_XTIMING))
+      {  // Stamp only what is used
          pET= extT+0;
          if (NULL == pRefTS) { pRefTS= aec.targetTS+0; }
+         if (pM->modeFlags & ADS1X_MODE_XTIMING) { aec.arc.tsMask= EXT_RTS_MASK_ALL; }
+         else
+         {
+            if (pTE) { aec.arc.tsMask= (1<<EXT_RTS_WRCFG_END) | (1<<EXT_RTS_RDVAL_BGN); }
+            else { aec.arc.tsMask= 1<<pM->timeEst; }
+            if (pCW) { aec.arc.tsMask|= 1<<iTS; }
+         }
       }
       do
       {
-         r= readAutoRawADS1x(aec.rawAGR, pET, aec.arc.nMux, aec.targetTS+1, &(aec.arc)); //LOG("readAutoRawADS1x() - r=%d\n", r);
+         if (pM->modeFlags & ADS1X_MODE_PIPE)
+         { r= readPipeRawADS1x(aec.rawAGR, pET, aec.arc.nMux, aec.targetTS+1, &(aec.arc)); }
+         else
+         { r= readAutoRawADS1x(aec.rawAGR, pET, aec.arc.nMux, aec.targetTS+1, &(aec.arc)); } //LOG("readAutoRawADS1x() - r=%d\n", r);
          if (r > 0)
          {
             convertRawAGR(rV+n, aec.rawAGR, aec.arc.nMux, pP);
+            if (vOK) { validRawAGR(vOK+n, aec.rawAGR, aec.arc.nMux); }
+            if (pCW)
+            {
+               adsCaptAdd(pCW, aec.rawAGR, pET[0].ts+iTS, EXT_RTS_COUNT, aec.arc.nMux);
+            }
             if (pDT)
             {  // Convert post-reading time stamp to elapsed since reference
-               if (NULL == pEstRTS) // pM->timeEst < EXT_RTS_COUNT)
+               if (NULL == pTE)
                { elapsedStrideRTS(pDT+n, aec.arc.nMux, pET[0].ts+pM->timeEst, EXT_RTS_COUNT, pRefTS); }
                else
-               { elapsedEstStrideRTS(pDT+n, aec.arc.nMux, pET[0].ts, EXT_RTS_COUNT, pRefTS, pEstRTS); }
+               { elapsedFitRTS(pDT+n, pSD ? pSD+n : NULL, aec.arc.nMux, pET, pRefTS, pTE); }
             }
 
             if FLAGS_ARE_SET( ADS1X_MODE_XTIMING|ADS1X_MODE_VERBOSE, pM->modeFlags)
@@ -315,56 +424,150 @@ static const char *dtID[]= {"rdvE","rdvB","cfgE","cfgB","muxB"};
          sumTransDT[0]= 2 * n;
          reportStat(sumTransDT, 1000, sumTransDT[0]-1);
       }
+      if (pTE && (pTE->nSD > 0))
+      {
+         report(LOG0,"time fit: latency %G ms (%u observations), uncertainty mean %G ms, max %G ms\n",
+            1000 * pTE->pLF->mean, pTE->pLF->k, 1000 * pTE->sumSD / pTE->nSD, 1000 * pTE->maxSD);
+      }
+      if (aec.arc.pPG)
+      {
+         report(LOG0,"predictive gain: %u changes, %u re-conversions saved, %u fallback\n", pg.nPred, pg.nSaved, pg.nReConv);
+      }
       if (pCfgPB) { memcpy(pCfgPB, aec.arc.cfgPB, ADS1X_NRB); } // Copy back any changes
    }
    return(n);
 } // readAutoADS1X
 
+#define ADS1X_CONT_BLK 32
+
+// Continuous conversion variant of the above: single (first) mux channel only
+int readContADS1X
+(
+   F32        rV[],  // result Voltage
+   F32        *pDT,  // result time difference from reference (optional)
+   U8         vOK[], // result valid flags (optional)
+   const int nMax,  // Max readings
+   const RawTimeStamp *pRefTS,
+   U8 * pCfgPB,   // Optional device config register bytes (initial value modified)
+   const LXI2CBusCtx *pC,
+   const ADSInstProp *pP,
+   const ADSReadParam *pM,
+   ADSCaptWriter *pCW   // Optional binary capture
+)
+{
+   RawAGR agr[ADS1X_CONT_BLK];
+   RawTimeStamp ts[ADS1X_CONT_BLK];
+   AutoExtCtx aec;
+   int n=0, r=-1;
+
+   if (nMax > 0)
+   {
+      r= setupAEC(&aec, pP, pM, pCfgPB, pC);
+      if (r < 0) { return(r); }
+      if (aec.arc.nMux > 1) { WARN_CALL("() - nMux=%d, using %s only\n", aec.arc.nMux, ads1xMuxStr(pM->mux[0])); }
+      if (NULL == pRefTS) { pRefTS= aec.targetTS+0; }
+      for (int i=0; i<ADS1X_CONT_BLK; i++) { agr[i]= aec.rawAGR[0]; }
+      r= startContADS1x(agr+0, &(aec.arc));
+      if (r > 0)
+      {  // First result available after one conversion interval
+         timeSetTarget(aec.targetTS+1, NULL, aec.arc.ivlNanoSec[0], TIME_MODE_NOW);
+         do
+         {  // Only records actually read are converted, captured & timestamped
+            const int m= readContRawADS1x(agr, ts, MIN(ADS1X_CONT_BLK, nMax-n), aec.targetTS+1, &(aec.arc), &r);
+            convertRawAGR(rV+n, agr, m, pP);
+            if (vOK) { validRawAGR(vOK+n, agr, m); }
+            if (pCW) { adsCaptAdd(pCW, agr, ts, 1, m); }
+            if (pDT) { elapsedStrideRTS(pDT+n, m, ts, 1, pRefTS); }
+            n+= m;
+            if (m <= 0) { break; }
+         } while ((n < nMax) && (r >= 0));
+         if (r < 0) { WARN_CALL("() - read failed after %d samples\n", n); }
+         stopContADS1x(&(aec.arc));
+      }
+      if (pCfgPB) { memcpy(pCfgPB, aec.arc.cfgPB, ADS1X_NRB); } // Copy back any changes
+   }
+   return(n);
+} // readContADS1X
+
+#define ADS1X_DEC_BLK 256
+
+// Decimate interleaved mux channel voltages (with timestamps & optional validity), dumping result
+int decimateADS (const F32 v[], const F32 dt[], const U8 vOK[], const int nV, const int dec, const ADSReadParam *pM)
+{
+   static FIRDecim fd; // NB: static for stack economy
+   const int nMux= pM->nMux, maxY= nV / (nMux * dec) + 1;
+   const F32 timeScale= 1000;
+   F32 *pB, *pY[FIRD_CHAN_MAX], *pTY[FIRD_CHAN_MAX];
+   RawTimeStamp ts;
+   int nY[FIRD_CHAN_MAX]={0}, n=0;
+   F32 t;
+
+   if (firDecimInit(&fd, nMux, dec, MIN(8 * dec - 1, FIRD_TAPS_MAX - 1), 0.8) <= 0) { return(-1); }
+   pB= malloc(2 * nMux * maxY * sizeof(*pB));
+   if (NULL == pB) { return(-1); }
+   for (int c=0; c<nMux; c++) { pY[c]= pB + c * maxY; pTY[c]= pB + (nMux + c) * maxY; }
+
+   timeNow(&ts);
+   for (int i=0; i<nV; i+= ADS1X_DEC_BLK)
+   {  // Block-wise (as if streaming), output appended per channel
+      n+= firDecimProcess(&fd, pY, pTY, nY, maxY, v+i, dt+i, vOK ? vOK+i : NULL, MIN(ADS1X_DEC_BLK, nV-i));
+   }
+   t= timeElapsed(&ts);
+   report(LOG0,"decimate x%d, %d taps: %d -> %d samples, %G ns/sample\n", dec, fd.nTaps, nV, n, t * 1E9 * rcpF(nV));
+   report(LOG0,"\t");
+   for (int c=0; c<nMux; c++) { LOG("%s%c", ads1xMuxStr(pM->mux[c]), gSepCh[c >= (nMux-1)] ); }
+   for (int j=0; j<nY[0]; j++)
+   {  // NB: a partial final scan leaves later channels one output short
+      report(LOG0,"dt (ms)\t\t");
+      for (int c=0; c<nMux; c++) { if (j < nY[c]) { report(LOG0,"%G", pTY[c][j] * timeScale); } report(LOG0,"%c", gSepCh[c >= (nMux-1)]); }
+      report(LOG0,"V (V)\t\t");
+      for (int c=0; c<nMux; c++) { if (j < nY[c]) { report(LOG0,"%G", pY[c][j]); } report(LOG0,"%c", gSepCh[c >= (nMux-1)]); }
+   }
+   free(pB);
+   return(n);
+} // decimateADS
+
 int testAutoGain
 (
    const int maxSamples,
    const LXI2CBusCtx  *pC,
    const ADSInstProp  *pP,
    const ADSReadParam *pM,
-   const ADSResDiv    *pRD
+   const ADSResDiv    *pRD,
+   const char *captPath, // Optional binary capture file (replaces text dump)
+   const int dec         // Decimation factor (>1 replaces text dump with filtered output)
 )
 {
    RawTimeStamp   ts;
    const U8 rateID= ads1xSelectRate(pM->rate[1], pP->hwID);
-   U8 cfgPB[ADS1X_NRB];
-   F32 dt=0, *pV, *pDT;
+   ADSCaptWriter cw, *pCW= NULL;
+   U8 cfgPB[ADS1X_NRB], *pOK= NULL;
+   F32 dt=0, *pV, *pDT, *pSD= NULL;
    int r;
 
    if (maxSamples <= 0) { return(0); }
    const U32 maxSM= pM->nMux * maxSamples;
-   pV= malloc(maxSM * (sizeof(*pV) + sizeof(*pDT)));
+   pV= calloc(1, 3 * maxSM * sizeof(*pV) + maxSM);
    if (NULL == pV) return(-1);
    pDT= pV + maxSM;
+   if (pM->timeEst >= EXT_RTS_COUNT) { pSD= pDT + maxSM; } // fitted timing
+   if (dec > 1) { pOK= (U8*)(pV + 3 * maxSM); } // decimation holds over invalid samples
 
    r= ads1xRateToU(rateID, pP->hwID);
    LOG_CALL("(..rate=[%d,%d]) - selected id=%d -> %d\n", pM->rate[0], pM->rate[1], rateID, r);
-   cfgPB[0]= ADS1X_REG_CFG;
-   r= lxi2cReadRB(pC, pP->busAddr, cfgPB, ADS1X_NRB);
-   //LOG_CALL("(...rateID=%d...) : ReadRB() r=%d \n", rateID, r);
-   if (r > 0)
-   {
-      r= ads1xGetRate(cfgPB+1);
-      //LOG("\tcfg=%02X%02X rateID=%d \n",cfgPB[1], cfgPB[2], r);
-      if (rateID == r) { r= 1; }
-      else
-      {
-         ads1xSetRate(cfgPB+1, rateID);
-         r= lxi2cWriteRB(pC, pP->busAddr, cfgPB, ADS1X_NRB);
-         //LOG_CALL(" : WriteRB() cfg=%02X%02X r=%d\n", cfgPB[1], cfgPB[2], r);
-      }
-   }
+   r= ads1xSyncRate(cfgPB, pC, pP->busAddr, rateID);
    if (r > 0)
    {
       timeNow(&ts);
-      r= readAutoADS1X(pV, pDT, maxSM, &ts, cfgPB, pC, pP, pM);
+      if (captPath && (adsCaptOpen(&cw, captPath, pP, pM, &ts) > 0)) { pCW= &cw; }
+      if (pM->modeFlags & ADS1X_MODE_CONT) { r= readContADS1X(pV, pDT, pOK, maxSM, &ts, cfgPB, pC, pP, pM, pCW); }
+      else { r= readAutoADS1X(pV, pDT, pSD, pOK, maxSM, &ts, cfgPB, pC, pP, pM, pCW); }
       dt= timeElapsed(&ts);
       report(LOG0,"%d samples, dt= %G sec : mean rate= %G Hz\n\n", r, dt, r * rcpF(dt));
       analyseInterval(pDT, pM->nMux, maxSamples);
+      if (pCW) { report(LOG0,"%s : %d blocks\n", captPath, adsCaptClose(pCW)); }
+      else if (dec > 1) { decimateADS(pV, pDT, pOK, r, dec, pM); }
+      else
       {  // dump
          const U8 nMux= pM->nMux; // Hacky...
          const F32 timeScale= 1000;
@@ -376,6 +579,11 @@ int testAutoGain
             report(LOG0,"[ %d..%d ] : \n", n, n+nMux-1);
             report(LOG0,"dt (ms)\t\t");
             for (int i=0; i<nMux; i++) { report(LOG0,"%G%c", pDT[n+i] * timeScale, gSepCh[i >= (nMux-1)]); }
+            if (pSD)
+            {
+               report(LOG0,"sd (ms)\t\t");
+               for (int i=0; i<nMux; i++) { report(LOG0,"%G%c", pSD[n+i] * timeScale, gSepCh[i >= (nMux-1)]); }
+            }
             report(LOG0,"V (V)\t\t");
             for (int i=0; i<nMux; i++) { report(LOG0,"%G%c", pV[n+i], gSepCh[i >= (nMux-1)]); }
 
@@ -399,6 +607,239 @@ int testAutoGain
    return(r);
 } // testAutoGain
 
+// Simulated AIN0 is 0.5V +/-0.25V (lxI2CSim.c): tolerance covers 12bit quantisation at lowest gain
+#define ADS1X_CHK_VLO (0.24)
+#define ADS1X_CHK_VHI (0.76)
+
+int checkPipeGain (const int nScan, const LXI2CBusCtx *pC, const ADSInstProp *pP)
+{
+   const ADSReadParam m= { { 0, 860 }, { ADS1X_MUX0G }, 1, 0x1, EXT_RTS_RDVAL_END, ADS1X_MODE_PIPE };
+   AutoExtCtx aec;
+   U8 g, gPrev= ADS1X_GAIN_6V144;
+   int nChg= 0, nOK= 0, nBad= 0, r;
+
+   r= setupAEC(&aec, pP, &m, NULL, pC);
+   if (r < 0) { return(r); }
+   ads1xSetGain(aec.rawAGR[0].cfgRB0, gPrev); // least sensitive: auto-gain must raise
+   for (int i=0; i<nScan; i++)
+   {
+      r= readPipeRawADS1x(aec.rawAGR, NULL, 1, aec.targetTS+1, &(aec.arc));
+      if (r < 0) { break; }
+      g= ads1xGetGain(aec.rawAGR[0].cfgRB0);
+      nChg+= (g != gPrev);
+      gPrev= g;
+      if (aec.rawAGR[0].flSt & AGR_FLAG_VROK)
+      {
+         F32 v;
+         convertRawAGR(&v, aec.rawAGR, 1, pP);
+         if ((v >= ADS1X_CHK_VLO) && (v <= ADS1X_CHK_VHI)) { nOK++; }
+         else
+         {
+            report(LOG0,"\tscan %d: gain %d raw %d -> %GV out of range\n", i, g, aec.rawAGR[0].res, v);
+            nBad++;
+         }
+      }
+   }
+   report(OUT,"Pipelined gain check: %d scans, %d gain changes, %d valid, %d bad -> %s\n", nScan, nChg, nOK, nBad,
+      ((r >= 0) && (nChg > 0) && (nOK > 0) && (0 == nBad)) ? "PASS" : "FAIL");
+   if ((r < 0) || (0 == nChg) || (0 == nOK) || (nBad > 0)) { return(-1); }
+   return(nOK);
+} // checkPipeGain
+
+#define ADS1X_CHK_NREC  (240)   // Multiple of vector width & resistance pattern length (nMux 1..4)
+#define ADS1X_CHK_ULP   (4)     // Tolerance (resistance: division vs. reciprocal multiply)
+
+static int cmpULP (const F32 a, const F32 b) { return(fabs(a - b) <= (ADS1X_CHK_ULP * FLT_EPSILON) * MAX(fabs(a), fabs(b))); }
+
+int checkBatchConv (const ADSInstProp *pP, const ADSResDiv *pRD, const int nMux)
+{
+   static const I16 raw[]= { -32768, -2049, -1, 0, 1, 0x3F, 0x7FF, 0x1000, 0x4000, 0x7FFF };
+   ADSScaleTab st;
+   ADSResDivPat rdp;
+   RawAGR r[ADS1X_CHK_NREC];
+   F32 v[2][ADS1X_CHK_NREC], res[2][ADS1X_CHK_NREC];
+   int nV= 0, nR= 0;
+
+   if (ads1xInitResDivPat(&rdp, pRD, nMux, pP) <= 0) { return(-1); }
+   ads1xInitScaleTab(&st, pP);
+   for (int i=0; i<ADS1X_CHK_NREC; i++)
+   {  // Every gain code (incl. aliases 5..7) against each raw value, valid & invalid
+      const int k= i / (ADS1X_GAIN_M+1);
+      r[i].res= raw[k % (sizeof(raw)/sizeof(raw[0]))];
+      r[i].cfgRB0[0]= ADS1X_FL0_OS | ADS1X_FL0_MODE;
+      ads1xSetMux(r[i].cfgRB0, ADS1X_MUX0G + (i % nMux));
+      ads1xSetGain(r[i].cfgRB0, i & ADS1X_GAIN_M);
+      r[i].flSt= AGR_FLAG_AUTO | (((k / 10) & 1) ? 0 : AGR_FLAG_VROK) | 2;
+   }
+   convertRawAGR(v[0], r, ADS1X_CHK_NREC, pP);
+   for (int i=0; i<ADS1X_CHK_NREC; i+= nMux) { adsGetResDiv(res[0]+i, v[0]+i, nMux, pRD, pP); }
+   ads1xResDivBatch(v[1], res[1], r, ADS1X_CHK_NREC, &st, &rdp);
+   for (int i=0; i<ADS1X_CHK_NREC; i++)
+   {
+      if (v[0][i] == v[1][i]) { nV++; }
+      else { report(OUT,"	[%d] raw=%d gain=%u : V %G != %G\n", i, r[i].res, ads1xGetGain(r[i].cfgRB0), v[0][i], v[1][i]); }
+      if (cmpULP(res[0][i], res[1][i])) { nR++; }
+      else { report(OUT,"	[%d] raw=%d gain=%u : R %G != %G\n", i, r[i].res, ads1xGetGain(r[i].cfgRB0), res[0][i], res[1][i]); }
+   }
+   report(OUT,"Batch conversion check: %d records, %d mux, V %d equal, R %d within %dulp -> %s\n", ADS1X_CHK_NREC, nMux,
+      nV, nR, ADS1X_CHK_ULP, ((ADS1X_CHK_NREC == nV) && (ADS1X_CHK_NREC == nR)) ? "PASS" : "FAIL");
+   if ((ADS1X_CHK_NREC != nV) || (ADS1X_CHK_NREC != nR)) { return(-1); }
+   return(nV);
+} // checkBatchConv
+
+// Statistics computed directly from mapped capture file
+int analyseCapture (const char *path)
+{
+   ADSCaptMap cm;
+   ADSScaleTab st;
+   StatMomD1R2 sm[ADS1X_MUX_MAX]={0,}, si={0,};
+   U64 tLast[ADS1X_MUX_MAX]={0,};
+   F32 *pV;
+   int r, nR= 0;
+
+   r= adsCaptMap(&cm, path);
+   if (r <= 0) { return(r); }
+   const ADSCaptHdr *pH= cm.pH;
+   pV= malloc(pH->blkRec * sizeof(*pV));
+   if (pV)
+   {
+      ads1xInitScaleTab(&st, &(pH->inst));
+      for (U32 b=0; b<cm.nBlk; b++)
+      {
+         const ADSCaptBlk *pB= adsCaptBlk(&cm, b);
+         const U8 *pS= adsCaptStatus(pB, pH->blkRec);
+         const U32 nRec= MIN(pB->nRec, pH->blkRec); // corrupt block cannot overrun
+         ads1xConvertCols(pV, adsCaptRes(pB, pH->blkRec), adsCaptGain(pB, pH->blkRec), pS, nRec, &st);
+         for (U32 j=0; j<nRec; j++)
+         {
+            if (pS[j] & AGR_FLAG_VROK) { statMom1Add(sm + (j % pH->nMux), pV[j]); }
+         }
+         addIntervalNS(&si, tLast, pB->tNS, pH->nMux, nRec / pH->nMux);
+         nR+= nRec;
+      }
+      free(pV);
+      report(LOG0,"%s : %u blocks, %d records, %d mux channels, hwID=%u busAddr=%02X\n", path, cm.nBlk, nR, pH->nMux, pH->inst.hwID, pH->inst.busAddr);
+      reportInterval(&si);
+      for (int i=0; i<pH->nMux; i++)
+      {
+         StatResD1R2 sr;
+         statMom1Res1(&sr, sm+i, sm[i].m[0]-1);
+         report(LOG0,"\t[%d] %s : n=%G mean=%G stdev=%G (V)\n", i, ads1xMuxStr(pH->muxMap[i]), sm[i].m[0], sr.m, sqrt(sr.v));
+      }
+   }
+   adsCaptUnmap(&cm);
+   return(nR);
+} // analyseCapture
+
+int testMultiADS1x
+(
+   const int maxSamples,
+   const LXI2CBusCtx  *pC,
+   const ADSInstProp  ip[],
+   const int nDev,
+   const ADSReadParam *pM
+)
+{
+   static ADSMultiCtx mc; // NB: static for stack economy
+   static ADSPredGain pg[ADS1X_DEV_MAX];
+   StatMomD1R2 sm[ADS1X_DEV_MAX][ADS1X_MUX_MAX];
+   RawTimeStamp ts, target[1], wait[1];
+   F32 v[ADS1X_MUX_MAX], dt;
+   int r, n= 0, nOK= 0, s= 0;
+
+   if (maxSamples <= 0) { return(0); }
+   r= setupMultiAEC(&mc, ip, nDev, pM, pC);
+   if (r <= 0) { return(-1); }
+   if (pM->modeFlags & ADS1X_MODE_PRED)
+   {
+      memset(pg, 0, sizeof(pg));
+      for (int d=0; d<mc.nDev; d++) { mc.aec[d].arc.pPG= pg+d; }
+   }
+
+   memset(sm, 0, sizeof(sm));
+   timeNow(&ts);
+   target[0]= ts;
+   do
+   {
+      r= readMultiRawADS1x(&mc, NULL);
+      nOK+= r;
+      for (int d=0; d<mc.nDev; d++)
+      {
+         const AutoExtCtx *pE= mc.aec+d;
+         convertRawAGR(v, pE->rawAGR, pE->arc.nMux, ip+d);
+         for (int i=0; i<pE->arc.nMux; i++)
+         {
+            if (pE->rawAGR[i].flSt & AGR_FLAG_VROK) { statMom1Add(sm[d]+i, v[i]); }
+         }
+         n+= pE->arc.nMux;
+      }
+      if (mc.aec[0].outerIvlNanoSec > 0)
+      {  // Pace scans at outer rate
+         timeSetTarget(target, NULL, mc.aec[0].outerIvlNanoSec, TIME_MODE_RELATIVE);
+         timeSpinWaitUntil(wait, target);
+      }
+   } while ((++s < maxSamples) && (r >= 0));
+   dt= timeElapsed(&ts);
+   report(LOG0,"%d devices, %d samples (%d valid), dt= %G sec : aggregate rate= %G Hz\n", mc.nDev, n, nOK, dt, n * rcpF(dt));
+   for (int d=0; d<mc.nDev; d++)
+   {
+      for (int i=0; i<mc.aec[d].arc.nMux; i++)
+      {
+         StatResD1R2 sr;
+         statMom1Res1(&sr, sm[d]+i, sm[d][i].m[0]-1);
+         report(LOG0,"\t0x%02X[%d] %s : n=%G mean=%G stdev=%G (V)\n", ip[d].busAddr, i, ads1xMuxStr(pM->mux[i]), sm[d][i].m[0], sr.m, sqrt(sr.v));
+      }
+      if (mc.aec[d].arc.pPG)
+      {
+         report(LOG0,"\t0x%02X predictive gain: %u changes, %u re-conversions saved, %u fallback\n", ip[d].busAddr, pg[d].nPred, pg[d].nSaved, pg[d].nReConv);
+      }
+   }
+   return(n);
+} // testMultiADS1x
+
+#define ADS1X_WATCH_GPIO_CHIP "/dev/gpiochip0"
+
+int testWatchADS1x
+(
+   const int maxEvents,
+   const LXI2CBusCtx  *pC,
+   const ADSInstProp  *pP,
+   const ADSReadParam *pM,
+   const F32 vLo, const F32 vHi,
+   const int gpioLine
+)
+{
+   ADSWatchCtx wc;
+   ADSWatchParam wp;
+   RawAGR agr;
+   RawTimeStamp ts0, ts;
+   const F32 vMax= MAX(fabs(vLo), fabs(vHi));
+   F32 v;
+   int r, n= 0;
+
+   wp.vLo= vLo; wp.vHi= vHi;
+   wp.mux= pM->mux[0];
+   wp.gainID= pP->minUGID; // Highest gain (smallest full scale) covering window
+   for (int g= pP->maxUGID; g > pP->minUGID; g--) { if (ads1xGainToFSV(g) >= vMax) { wp.gainID= g; break; } }
+   wp.rateID= ads1xSelectRate(pM->rate[0], pP->hwID);
+   wp.nAssert= 2;
+
+   r= ads1xWatchStart(&wc, pP, &wp, pC, (gpioLine >= 0) ? ADS1X_WATCH_GPIO_CHIP : NULL, gpioLine, 0);
+   if (r < 0) { return(r); }
+   report(LOG0,"Watch %s [%G, %G]V (raw %d, %d) gain %GV, %u Hz : %s\n", ads1xMuxStr(wp.mux), vLo, vHi,
+      wc.rLo, wc.rHi, ads1xGainToFSV(wp.gainID), ads1xRateToU(wp.rateID, pP->hwID), r ? "ALERT event" : "polled");
+   timeNow(&ts0);
+   while ((n < maxEvents) && ((r= ads1xWatchWait(&wc, &agr, &ts, -1)) > 0))
+   {
+      convertRawAGR(&v, &agr, 1, pP);
+      report(OUT,"%G%c%G\n", timeDiff(&ts0, &ts), gSepCh[0], v);
+      n++;
+   }
+   ads1xWatchStop(&wc);
+   report(LOG0,"%d events, %u wake-ups, %u transactions in %G sec\n", n, wc.nWake, wc.nTrans, timeElapsed(&ts0));
+   return(n);
+} // testWatchADS1x
+
 
 /***/
 
@@ -416,13 +857,19 @@ int testADS1x15
 )
 {
    ADS1xFullPB fpb;
-   const long i2cWait= ADS1X_TRANS_NCLK * (float)NANO_TICKS / pC->clk;
+   const long i2cWait= lxi2cTransNS(pC, ADS1X_TRANS_NCLK);
    RawTimeStamp timer;
    int i2cDelay=0, convWait=0, expectWait=0, minWaitStep=10;
    int r, n;
    float sv;
    U8 cfgStatus[ADS1X_NRB];
+   // Config verify: brief backoff (bus noise) ; status poll: immediate (each read spans a bus transaction)
+   // Any error class may be retried, but no more than the previous fixed limit of 9 overall
+   static const LXRetryPolicy verRetry= { 100000, 1000000, 5000000, {9, 9, 9, 9}, LX_RETRY_EXP, 9 };
+   static const LXRetryPolicy pollRetry= { 0, 0, 0, {9, 9, 9, 9}, LX_RETRY_FIXED, 9 };
+   LXRetryStat rs[2];
 
+   memset(rs, 0, sizeof(rs));
    r= ads1xInitFPB(&fpb, pWS, pC, pP->busAddr);
    if (r >= 0)
    {
@@ -453,6 +900,9 @@ int testADS1x15
       {
          int iR0= 0, iR1= 0; // retry counters
          U8 cfgVer=FALSE;
+         LXRetry rt;
+
+         lxRetryBegin(&rt, &verRetry, rs+0);
          do
          {
             r= lxi2cWriteRB(pC, pP->busAddr, fpb.rc.cfg, ADS1X_NRB);
@@ -466,15 +916,20 @@ int testADS1x15
                   if (pM->modeFlags & ADS1X_MODE_VERBOSE) { LOG("ver%d=%d: ", iR0, cfgVer); ads1xDumpCfg(cfgStatus+1, pP->hwID); }
                }
             }
-         } while ((pM->modeFlags & ADS1X_TEST_MODE_VERIFY) && ((r < 0) || !cfgVer) && (++iR0 < 10));
+         } while ((pM->modeFlags & ADS1X_TEST_MODE_VERIFY) && ((r < 0) || !cfgVer) && lxRetryAgain(&rt, (r < 0) ? errno : 0));
+         iR0= rt.nTry;
+         lxRetryEnd(&rt, r);
 
          if (expectWait > 0) { timeSpinSleep(expectWait); }
 
          if (pM->modeFlags & ADS1X_TEST_MODE_POLL)
          {
+            lxRetryBegin(&rt, &pollRetry, rs+1);
             do { // poll status
                r= lxi2cReadRB(pC, pP->busAddr, cfgStatus, ADS1X_NRB);
-            } while (((r < 0) || (0 == (cfgStatus[1] & ADS1X_FL0_OS))) && (++iR1 < 10));
+            } while (((r < 0) || (0 == (cfgStatus[1] & ADS1X_FL0_OS))) && lxRetryAgain(&rt, (r < 0) ? errno : 0));
+            iR1= rt.nTry;
+            lxRetryEnd(&rt, r);
          }
 
          r= lxi2cReadRB(pC, pP->busAddr, fpb.rc.res, ADS1X_NRB); // read result
@@ -512,6 +967,8 @@ int testADS1x15
          }
       } while (++n < maxSamples);
       LOG("%s\n","---");
+      if (pM->modeFlags & ADS1X_TEST_MODE_VERIFY) { lxRetryDump("Verify retry", rs+0, LOG0); }
+      if (pM->modeFlags & ADS1X_TEST_MODE_POLL) { lxRetryDump("Poll retry", rs+1, LOG0); }
    }
    return(r);
 } // testADS1x15
@@ -521,7 +978,10 @@ int testADS1x15
 
 #ifdef ADS1X_MAIN
 
-#include "ads1xTxtIF.h"
+#include "ads1xThread.h"
+#include "lxI2CSim.h"
+#include "lxI2CReplay.h"
+#include "lxI2CProf.h"
 
 int ads1xMuxMap (U8 m[], const char *s, const U8 hwID)
 {
@@ -535,7 +995,16 @@ typedef struct
    char devPath[14]; // host device path
    U8 hwID;
    U8 busAddr;
-   U8 testFlags;
+   U8 nDev, dec;
+   U16 testFlags;
+   const char *captPath, *readPath; // binary capture output / input for analysis
+   F32 watch[2];  // threshold window (Volts)
+   int gpioLine;  // ALERT/RDY line on gpiochip0 (<0 -> none)
+   int fifoPrio;  // SCHED_FIFO priority for multi-bus workers (0 -> default policy)
+   U8 nBus;
+   char busIdx[ADS1X_BUS_MAX]; // device index of each bus (multi-bus)
+   const char *trcPath, *rplPath; // bus transaction trace output / replay input
+   U8 rplFlags;
 } ADS1XArgs;
 
 static ADS1XArgs gArgs=
@@ -545,13 +1014,14 @@ static ADS1XArgs gArgs=
       0x0F, EXT_RTS_RDVAL_END, 0    // maskAG, timeEst, modeFlags
    },
    32,   // samples
-   "/dev/i2c-1", ADS10, 0x48, 0
+   "/dev/i2c-1", ADS10, 0x48, 1, 1, 0,
+   NULL, NULL, { 0, 0 }, -1
 };
 
 void usageMsg (const char name[])
 {
-static const char optCh[]="adimnrAvhMT";
-static const char argCh[]="######    #";
+static const char optCh[]="adimnNrDAPCGptvhMToRWgBFSXYyQKVb";
+static const char argCh[]="########         ####### ###    ";
 static const char *desc[]=
 {
    "I2C bus address: 2digit hex (no prefix)",
@@ -559,12 +1029,33 @@ static const char *desc[]=
    "hardware ID: 0 -> ads10xx, 1 -> ads11xx",
    "multiplexer channel count",
    "max samples",
+   "device count (consecutive bus addresses, interleaved scheduling)",
    "sample rate",
+   "decimation factor (FIR low pass, auto gain mode)",
    "auto gain mode",
+   "pipelined mux scan (auto gain mode only)",
+   "continuous conversion streaming (auto gain mode, single mux channel)",
+   "predictive gain selection from per-channel history (auto gain mode)",
+   "plan data & scan rates from required channel rate (-r) and bus timing",
+   "threaded acquisition (ring buffered, output to stdout)",
    "verbose diagnostic messages",
    "help (display this text)",
-   "multiplexor selection (0/G,1/G,0/1,1/2 etc.)"
-   "timestamp control"
+   "multiplexor selection (0/G,1/G,0/1,1/2 etc.)",
+   "timestamp: 0..4 -> raw stamp (ExtRawTiming index), 5+ -> sliding window fit",
+   "binary capture output file path (auto gain mode)",
+   "analyse binary capture file (no device access)",
+   "watch (threshold window, Volts) lo:hi on first mux channel, report excursions",
+   "GPIO line (gpiochip0) connected to ALERT/RDY for watch mode (default poll)",
+   "multi-bus parallel acquisition: device indices e.g. 1,3 (threaded, merged output to stdout)",
+   "SCHED_FIFO priority for multi-bus acquisition threads (requires privilege)",
+   "simulated bus & devices (no hardware required)",
+   "bus transaction trace output file path",
+   "replay bus transaction trace file (no hardware required) at captured timing",
+   "replay bus transaction trace file at maximum speed",
+   "profile bus occupancy & transfer latency (report on completion)",
+   "calibrate effective bus clock & per transfer overhead (timing predictions, planning)",
+   "check pipelined auto-gain conversion (implies simulated bus)",
+   "check batch (vectorised) against scalar conversion, all gain codes (no device required)"
 };
    const int n= sizeof(desc)/sizeof(desc[0]);
    report(OUT,"Usage : %s [-%s]\n", name, optCh);
@@ -579,16 +1070,24 @@ void paramDump (const ADSReadParam *pP)
    report(OUT,"\trate= %d, %d (Hz)", pP->rate[0], pP->rate[1]);
    report(OUT,"\tmux[%d]={", pP->nMux); reportBytes(OUT, pP->mux, pP->nMux);
    report(OUT,"%s", "}\n");
-   report(OUT,"\tmaskAG= 0x%02X, timeEst= 0x%02X, modeFlags= 0x%02X\n", pP->maskAG, pP->timeEst, pP->modeFlags);
+   report(OUT,"\tmaskAG= 0x%02X, timeEst= 0x%02X, modeFlags= 0x%03X\n", pP->maskAG, pP->timeEst, pP->modeFlags);
 } // paramDump
 
 void argDump (const ADS1XArgs *pA)
 {
-   report(OUT,"Device: devPath=%s, hwID:%d, busAddr=%02X\n", pA->devPath, pA->hwID, pA->busAddr);
-   report(OUT,"\tflags=%02X maxS=%d\n", pA->testFlags,  pA->maxSamples);
+   report(OUT,"Device: devPath=%s, hwID:%d, busAddr=%02X, nDev=%d\n", pA->devPath, pA->hwID, pA->busAddr, pA->nDev);
+   report(OUT,"\tflags=%03X maxS=%d\n", pA->testFlags,  pA->maxSamples);
    paramDump(&(pA->param));
 } // argDump
 
+#define ARG_BATCHCHK   (1<<10)
+#define ARG_GAINCHK (1<<9)
+#define ARG_CAL     (1<<8)
+#define ARG_PROF    (1<<7)
+#define ARG_SIM     (1<<6)
+#define ARG_WATCH   (1<<5)
+#define ARG_PLAN    (1<<4)
+#define ARG_THREAD  (1<<3)
 #define ARG_AUTO    (1<<2)
 #define ARG_HELP    (1<<1)
 #define ARG_VERBOSE (1<<0)
@@ -598,7 +1097,7 @@ void argTrans (ADS1XArgs *pA, int argc, char *argv[])
    int i, c, t;
    do
    {
-      c= getopt(argc,argv,"a:d:i:m:n:r:M:T:Ahv");
+      c= getopt(argc,argv,"a:d:i:m:n:r:D:M:N:T:o:R:W:g:B:F:X:Y:y:APCGSQKVbpthv");
       switch(c)
       {
          case 'a' :
@@ -624,10 +1123,18 @@ void argTrans (ADS1XArgs *pA, int argc, char *argv[])
             sscanf(optarg, "%d", &t);
             if (t > 0) { pA->maxSamples= t; }
             break;
+         case 'N' :
+            sscanf(optarg, "%d", &t);
+            if ((t > 0) && (t <= ADS1X_DEV_MAX)) { pA->nDev= t; }
+            break;
          case 'r' :
             sscanf(optarg, "%d", &t);
             if (t > 0) { pA->param.rate[0]= t; }
             break;
+         case 'D' :
+            sscanf(optarg, "%d", &t);
+            if ((t > 0) && (t <= 64)) { pA->dec= t; }
+            break;
          case 'M' :
             t= ads1xMuxMap(pA->param.mux, optarg, pA->hwID);
             //report(OUT,"* mux %d,%d *\n",pA->param.mux[0],pA->param.mux[1]);
@@ -639,9 +1146,71 @@ void argTrans (ADS1XArgs *pA, int argc, char *argv[])
             pA->param.timeEst= t;
             //packTE(EXT_RTS_WRCFG_END, EXT_RTS_RDVAL_BGN, 0.5); // EXT_RTS_RDVAL_END;
            break;
+         case 'o' :
+            pA->captPath= optarg;
+            break;
+         case 'R' :
+            pA->readPath= optarg;
+            break;
+         case 'W' :
+            if (2 == sscanf(optarg, "%f:%f", pA->watch+0, pA->watch+1)) { pA->testFlags|= ARG_WATCH; }
+            break;
+         case 'g' :
+            sscanf(optarg, "%d", &t);
+            if (t >= 0) { pA->gpioLine= t; }
+            break;
+         case 'B' :
+            pA->nBus= 0;
+            for (const char *pCh= optarg; *pCh && (pA->nBus < ADS1X_BUS_MAX); pCh++)
+            {
+               if ((*pCh >= '0') && (*pCh <= '9')) { pA->busIdx[pA->nBus++]= *pCh; }
+            }
+            break;
+         case 'F' :
+            sscanf(optarg, "%d", &t);
+            if ((t >= 0) && (t <= 99)) { pA->fifoPrio= t; }
+            break;
+         case 'X' :
+            pA->trcPath= optarg;
+            break;
+         case 'Y' :
+         case 'y' :
+            pA->rplPath= optarg;
+            pA->rplFlags= ('y' == c) ? LX_I2C_REPLAY_FAST : 0;
+            break;
          case 'A' :
             pA->testFlags|= ARG_AUTO;
             break;
+         case 'P' :
+            pA->param.modeFlags|= ADS1X_MODE_PIPE;
+            break;
+         case 'C' :
+            pA->param.modeFlags|= ADS1X_MODE_CONT;
+            break;
+         case 'G' :
+            pA->param.modeFlags|= ADS1X_MODE_PRED;
+            break;
+         case 'S' :
+            pA->testFlags|= ARG_SIM;
+            break;
+         case 'Q' :
+            pA->testFlags|= ARG_PROF;
+            break;
+         case 'K' :
+            pA->testFlags|= ARG_CAL;
+            break;
+         case 'V' :
+            pA->testFlags|= ARG_GAINCHK|ARG_SIM;
+            break;
+         case 'b' :
+            pA->testFlags|= ARG_BATCHCHK;
+            break;
+         case 'p' :
+            pA->testFlags|= ARG_PLAN;
+            break;
+         case 't' :
+            pA->testFlags|= ARG_THREAD;
+            break;
          case 'h' :
             pA->testFlags|= ARG_HELP;
             break;
@@ -656,29 +1225,136 @@ void argTrans (ADS1XArgs *pA, int argc, char *argv[])
       WARN_CALL("() - swapping rate order [%d,%d]\n", pA->param.rate[0], pA->param.rate[1]);
       SWAP(U16, pA->param.rate[0], pA->param.rate[1]);
    }
+   if ((pA->param.modeFlags & ADS1X_MODE_CONT) && (pA->param.nMux > 1))
+   {
+      WARN_CALL("() - continuous mode: nMux %d -> 1\n", pA->param.nMux);
+      pA->param.nMux= 1;
+   }
+   if ((pA->nDev > 1) && ((pA->busAddr + pA->nDev - 1) > 0x4B))
+   {
+      WARN_CALL("() - multiple devices: busAddr 0x%02X -> 0x48\n", pA->busAddr);
+      pA->busAddr= 0x48;
+   }
    if (pA->testFlags & ARG_HELP) { usageMsg(argv[0]); }
    if (pA->testFlags & ARG_VERBOSE) { argDump(pA); }
 } // argTrans
 
 LXI2CBusCtx gBusCtx={0,-1};
 
+// Planning assumptions: per transaction system call overhead (typical
+// for RPi class host) & fraction of conversions repeated by auto-gain
+#define ADS1X_PLAN_OVHD_NS (30000)
+#define ADS1X_PLAN_RECONV  (0.1)
+
+void planRate (ADSReadParam *pM, const LXI2CBusCtx *pC, const ADS1xHWID hwID, const U16 testFlags)
+{
+   ADSRatePlan rp;
+   U16 chanRate[ADS1X_MUX_MAX];
+   const F32 reconv= (testFlags & ARG_AUTO) ? ADS1X_PLAN_RECONV : 0;
+   int r;
+
+   for (int i=0; i<pM->nMux; i++) { chanRate[i]= pM->rate[0]; }
+   r= ads1xPlanRate(&rp, pM, chanRate, reconv, lxi2cClockEff(pC), (pC->clkEff > 0) ? pC->ovhdNS : ADS1X_PLAN_OVHD_NS, hwID);
+   if (r >= 0)
+   {
+      report(OUT,"Plan: %d channels @ %d Hz, bus %d Hz -> rateID=%d (%d Hz) %s\n", pM->nMux, rp.scanRate, lxi2cClockEff(pC), rp.rateID, pM->rate[1], r ? "OK" : "INFEASIBLE");
+      report(OUT,"\tconv=%ldus trans=%ldus scan=%ldus spare=%ldus/scan, bus utilisation=%.1f%%\n",
+         rp.convNS / 1000, rp.transNS / 1000, rp.scanNS / 1000, rp.spareNS / 1000, 100 * rp.busUtil);
+   }
+} // planRate
+
+// Open host bus, trace replay, or simulated bus with the expected devices attached
+Bool32 openBus (LXI2CBusCtx *pC, const char path[], const ADS1XArgs *pA)
+{
+   if (pA->rplPath) { return(lxi2cReplayOpen(pC, pA->rplPath, pA->rplFlags) > 0); }
+   if (pA->testFlags & ARG_SIM)
+   {
+      if (!lxi2cSimOpen(pC, 400, ADS1X_PLAN_OVHD_NS, 0)) { return(FALSE); }
+      for (int d=0; d<pA->nDev; d++) { lxi2cSimAddADS(pC, pA->busAddr+d, pA->hwID); }
+      return(TRUE);
+   }
+   return lxi2cOpen(pC, path, 400);
+} // openBus
+
+int multiBus (ADS1XArgs *pA)
+{
+   LXI2CBusCtx bc[ADS1X_BUS_MAX];
+   const ADSInstProp *pP= adsInitProp(NULL, 3.31, pA->hwID, pA->busAddr);
+   int b, r= -1;
+
+   for (b=0; b<pA->nBus; b++)
+   {
+      char path[sizeof(pA->devPath)];
+      memcpy(path, pA->devPath, sizeof(path));
+      path[9]= pA->busIdx[b];
+      if (!openBus(bc+b, path, pA)) { break; }
+   }
+   if (b >= pA->nBus)
+   {
+      pA->param.modeFlags|= ADS1X_MODE_XTIMING;
+      r= ads1xMultiBusAcq(pA->maxSamples, bc, pA->nBus, pP, &(pA->param), pA->fifoPrio, stdout);
+   }
+   while (b-- > 0) { lxi2cClose(bc+b); }
+   return(r);
+} // multiBus
+
 int main (int argc, char *argv[])
 {
    int r= -1;
 
    argTrans(&gArgs, argc, argv);
 
-   if (lxi2cOpen(&gBusCtx, gArgs.devPath, 400))
+   if (gArgs.readPath) { return analyseCapture(gArgs.readPath); } // no device required
+   if (gArgs.testFlags & ARG_BATCHCHK)
+   {  // ditto, all supported channel counts
+      const ADSResDiv resDiv= {{2200, 330, 330, 10000}};
+      const ADSInstProp *pP= adsInitProp(NULL, 3.31, gArgs.hwID, gArgs.busAddr);
+      for (int m=1; m<=ADS_RES_DIV_MAX; m++) { if (checkBatchConv(pP, &resDiv, m) < 0) { return(-1); } }
+      return(0);
+   }
+   if (gArgs.nBus > 1) { return multiBus(&gArgs); }
+   if (openBus(&gBusCtx, gArgs.devPath, &gArgs))
    {
+      LXI2CTrace trc={ NULL, 0, 0 };
+      LXI2CProfile *pPrf= NULL;
+      if (gArgs.testFlags & ARG_CAL)
+      {  // NB: before trace & profile
+         if (lxi2cClockCalibrate(&gBusCtx, gArgs.busAddr, ADS1X_REG_CFG) > 0)
+         {
+            report(OUT,"Bus clock: nominal %dHz, effective %dHz, overhead %.1fus\n", gBusCtx.clk, gBusCtx.clkEff, 1E-3 * gBusCtx.ovhdNS);
+         }
+      }
+      if (gArgs.trcPath) { lxi2cTraceStart(&gBusCtx, &trc, 1<<16); }
+      if ((gArgs.testFlags & ARG_PROF) && (pPrf= malloc(sizeof(*pPrf)))) { lxi2cProfStart(&gBusCtx, pPrf); }
       const ADSInstProp *pP= adsInitProp(NULL, 3.31, gArgs.hwID, gArgs.busAddr);
       gArgs.param.modeFlags|= ADS1X_MODE_XTIMING;
-      if (gArgs.testFlags & ARG_AUTO)
+      if (gArgs.testFlags & ARG_PLAN) { planRate(&(gArgs.param), &gBusCtx, gArgs.hwID, gArgs.testFlags); }
+      if (gArgs.nDev > 1)
+      {
+         ADSInstProp ip[ADS1X_DEV_MAX];
+         for (int d=0; d<gArgs.nDev; d++) { adsInitProp(ip+d, 3.31, gArgs.hwID, gArgs.busAddr+d); }
+         r= testMultiADS1x(gArgs.maxSamples, &gBusCtx, ip, gArgs.nDev, &(gArgs.param));
+      }
+      else if (gArgs.testFlags & ARG_WATCH)
+      {
+         r= testWatchADS1x(gArgs.maxSamples, &gBusCtx, pP, &(gArgs.param), gArgs.watch[0], gArgs.watch[1], gArgs.gpioLine);
+      }
+      else if (gArgs.testFlags & ARG_THREAD)
+      {
+         r= ads1xThreadAcq(gArgs.maxSamples, &gBusCtx, pP, &(gArgs.param), gArgs.captPath ? NULL : stdout, gArgs.captPath);
+      }
+      else if (gArgs.testFlags & ARG_GAINCHK)
+      {
+         r= checkPipeGain(gArgs.maxSamples, &gBusCtx, pP);
+      }
+      else if (gArgs.testFlags & ARG_AUTO)
       {
          ADSResDiv resDiv= {{2200, 330, 330, 10000}};
-         r= testAutoGain(gArgs.maxSamples, &gBusCtx, pP, &(gArgs.param), &resDiv);
+         r= testAutoGain(gArgs.maxSamples, &gBusCtx, pP, &(gArgs.param), &resDiv, gArgs.captPath, gArgs.dec);
       }
       else
       {
+         gArgs.param.modeFlags&= ADS1X_MODE_MASK; // NB: auto mode extensions not applicable
          gArgs.param.modeFlags|= ADS1X_TEST_MODE_VERIFY|ADS1X_TEST_MODE_SLEEP|ADS1X_TEST_MODE_POLL;
          // Paranoid enum check: for (int i=ADS11_DR8; i<=ADS11_DR860; i++) { printf("%d -> %d\n", i, ads1xRateToU(i,1) ); }
          //MemBuff ws={0,};
@@ -686,6 +1362,23 @@ int main (int argc, char *argv[])
          r= testADS1x15(gArgs.maxSamples, &gBusCtx, NULL, pP, &(gArgs.param));
          //releaseMemBuff(&ws);
       }
+      if (gArgs.trcPath)
+      {
+         lxi2cTraceStop(&gBusCtx);
+         report(OUT,"Trace: %d records -> %s\n", lxi2cTraceDump(&trc, gBusCtx.clk, gArgs.trcPath), gArgs.trcPath);
+         lxi2cTraceRelease(&trc);
+      }
+      if (pPrf)
+      {
+         lxi2cProfStop(&gBusCtx);
+         lxi2cProfDump(pPrf, OUT);
+         free(pPrf);
+      }
+      if (lxi2cReplayStat(&gBusCtx))
+      {
+         const LXI2CReplayStat *pS= lxi2cReplayStat(&gBusCtx);
+         report(OUT,"Replay: %u/%u matched, %u skipped, %u write differences, %u missed\n", pS->nMatch, pS->nTrans, pS->nSkip, pS->nWrDiff, pS->nMiss);
+      }
       lxi2cClose(&gBusCtx);
    }
 
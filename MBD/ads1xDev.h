@@ -48,11 +48,7 @@ extern int ads1xInitRB (ADS1xFullPB *pFPB, const MemBuff *pWS, const LXI2CBusCtx
 #define ADS1X_TEST_MODE_SLEEP   (1<<6) // Sleep for expected conversion interval
 #define ADS1X_TEST_MODE_POLL    (1<<5) // Poll the device for conversion ready flag
 #define ADS1X_TEST_MODE_TUNE    (1<<4) // Primitive performance tuning attempt
-#define ADS1X_MODE_MASK    (0x0F)   // Lower nybble mask applies to all
-#define ADS1X_MODE_X3      (1<<3)   // Presently unused
-#define ADS1X_MODE_X2      (1<<2)   //   "         "
-#define ADS1X_MODE_XTIMING (1<<1)   // Extended timing information
-#define ADS1X_MODE_VERBOSE (1<<0)   // Diagnostic info (to console)
+// NB: lower nybble ADS1X_MODE_* see ads1xAuto.h
 
 // Auto gain, & accurate timing test
 int testAutoGain
@@ -61,7 +57,30 @@ int testAutoGain
    const LXI2CBusCtx  *pC,
    const ADSInstProp  *pP,
    const ADSReadParam *pM,
-   const ADSResDiv    *pRD
+   const ADSResDiv    *pRD,
+   const char *captPath,
+   const int dec
+);
+
+// Pipelined auto-gain check on simulated bus: gain changes must not
+// disturb conversion of results to Volts. Returns <0 on failure.
+int checkPipeGain (const int nScan, const LXI2CBusCtx *pC, const ADSInstProp *pP);
+
+// Batch (vectorised) conversion check against convertRawAGR() & adsGetResDiv()
+// over all gain codes, for a scan of nMux channels. Returns <0 on failure.
+int checkBatchConv (const ADSInstProp *pP, const ADSResDiv *pRD, const int nMux);
+
+// Threshold watch: report maxEvents excursions of mux[0] outside [vLo,vHi]
+// using device comparator, ALERT via gpioLine (<0 -> result register polled
+// at the default ADS1X_WATCH_POLL_NS interval)
+int testWatchADS1x
+(
+   const int maxEvents,
+   const LXI2CBusCtx  *pC,
+   const ADSInstProp  *pP,
+   const ADSReadParam *pM,
+   const F32 vLo, const F32 vHi,
+   const int gpioLine
 );
 
 // Hacky mode tests
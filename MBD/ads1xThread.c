@@ -0,0 +1,339 @@
+// Common/MBD/ads1xThread.c - threaded acquisition for TI I2C ADC devices (ADS1xxx series)
+// https://github.com/DrAl-HFS/Common.git
+// Licence: AGPL3
+// (c) Project Contributors Sept 2021
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // CPU affinity
+#endif
+#include <pthread.h>
+#include <sched.h>
+#include <errno.h>
+#include "ads1xThread.h"
+#include "ads1xTxtIF.h"
+#include "ads1xBatch.h"
+
+
+/***/
+
+#define ADS1X_CON_BLK      (64)  // Records per consumer batch
+#define ADS1X_CON_IDLE_US  (500) // Consumer sleep when ring empty
+
+#define ATOMIC_GET(p)   __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define ATOMIC_SET(p,v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+
+/***/
+
+void *ads1xAcqThread (void *p)
+{
+   ADSThreadCtx *pTC= p;
+   AutoExtCtx *pAEC= &(pTC->aec);
+   const ADSReadParam *pM= pTC->pM;
+   const U8 iTS= (pM->timeEst < EXT_RTS_COUNT) ? pM->timeEst : EXT_RTS_RDVAL_END;
+   ExtRawTiming extT[ADS1X_MUX_MAX];
+   int r;
+
+   pAEC->arc.tsMask= 1<<iTS;
+   do
+   {
+      if (pM->modeFlags & ADS1X_MODE_PIPE)
+      { r= readPipeRawADS1x(pAEC->rawAGR, extT, pAEC->arc.nMux, pAEC->targetTS+1, &(pAEC->arc)); }
+      else
+      { r= readAutoRawADS1x(pAEC->rawAGR, extT, pAEC->arc.nMux, pAEC->targetTS+1, &(pAEC->arc)); }
+      if (r < 0) { pTC->acqErr= r; break; } // NB: scan incomplete, nothing pushed
+      for (int i=0; i<pAEC->arc.nMux; i++)
+      {  // NB: record dropped (and counted by ring) if consumer has fallen behind
+         ADSSampleRec *pS= spscWritePtr(&(pTC->ring));
+         if (pS)
+         {
+            pS->agr= pAEC->rawAGR[i]; // NB: possibly invalid (range fault), consumer filters
+            pS->iMux= i;
+            pS->iBus= pTC->iBus;
+            pS->ts= extT[i].ts[iTS];
+            spscWriteCommit(&(pTC->ring));
+         }
+      }
+      pTC->nAcq+= pAEC->arc.nMux;
+      if (pAEC->outerIvlNanoSec > 0)
+      {  RawTimeStamp wait[1];
+         timeSetTarget(pAEC->targetTS+1, NULL, pAEC->outerIvlNanoSec, TIME_MODE_RELATIVE);
+         timeSpinWaitUntil(wait+0, pAEC->targetTS+1);
+      }
+   } while (pTC->nAcq <= (pTC->maxSamples - pAEC->arc.nMux));
+   ATOMIC_SET(&(pTC->acqDone), 1);
+   return(NULL);
+} // ads1xAcqThread
+
+void *ads1xConThread (void *p)
+{
+   ADSThreadCtx *pTC= p;
+   ADSSampleRec s[ADS1X_CON_BLK];
+   RawAGR agr[ADS1X_CON_BLK];
+   RawTimeStamp ts[ADS1X_CON_BLK];
+   F32 v[ADS1X_CON_BLK];
+   ADSScaleTab st;
+   int n, done;
+
+   ads1xInitScaleTab(&st, pTC->pP);
+   do
+   {
+      done= ATOMIC_GET(&(pTC->acqDone)); // NB: must precede pop
+      n= spscPop(&(pTC->ring), s, ADS1X_CON_BLK);
+      if (n > 0)
+      {
+         for (int i=0; i<n; i++) { agr[i]= s[i].agr; ts[i]= s[i].ts; }
+         ads1xConvertBatch(v, agr, n, &st);
+         if (pTC->pCW) { adsCaptAdd(pTC->pCW, agr, ts, 1, n); }
+         for (int i=0; i<n; i++)
+         {
+            if (agr[i].flSt & AGR_FLAG_VROK) { statMom1Add(pTC->sm + s[i].iMux, v[i]); }
+            if (pTC->pOut) { fprintf(pTC->pOut, "%.6f\t%u\t%G\n", timeDiff(&(pTC->refTS), &(s[i].ts)), s[i].iMux, v[i]); }
+         }
+         pTC->nCons+= n;
+      }
+      else if (!done) { usleep(ADS1X_CON_IDLE_US); }
+   } while (!done || (n > 0));
+   if (pTC->acqErr < 0) { WARN_CALL("() - bus %u acquisition failed after %d samples (%d)\n", pTC->iBus, pTC->nAcq, pTC->acqErr); }
+   return(NULL);
+} // ads1xConThread
+
+// Complete device setup (may report) before acquisition thread starts
+static int setupThreadCtx (ADSThreadCtx *pTC, const U8 cfgPB[ADS1X_NRB])
+{
+   int r= setupAEC(&(pTC->aec), pTC->pP, pTC->pM, cfgPB, pTC->pC);
+   if (r >= 0)
+   {
+      if (pTC->pM->modeFlags & ADS1X_MODE_PRED)
+      {
+         memset(&(pTC->pg), 0, sizeof(pTC->pg));
+         pTC->aec.arc.pPG= &(pTC->pg);
+      }
+   }
+   pTC->acqDone= 0;
+   pTC->acqErr= 0;
+   return(r);
+} // setupThreadCtx
+
+int ads1xThreadAcq
+(
+   const int maxSamples,
+   const LXI2CBusCtx  *pC,
+   const ADSInstProp  *pP,
+   const ADSReadParam *pM,
+   FILE *pOut,
+   const char *captPath
+)
+{
+   static ADSThreadCtx tc; // NB: static for alignment & stack economy
+   ADSCaptWriter cw;
+   pthread_t th[2];
+   U8 cfgPB[ADS1X_NRB];
+   F32 dt;
+   int r;
+
+   if (maxSamples <= 0) { return(0); }
+   r= ads1xSyncRate(cfgPB, pC, pP->busAddr, ads1xSelectRate(pM->rate[1], pP->hwID));
+   if ((r <= 0) || !spscInit(&(tc.ring), ADS1X_RING_REC, sizeof(ADSSampleRec))) { return(-1); }
+
+   tc.pC= pC; tc.pP= pP; tc.pM= pM;
+   tc.pOut= pOut;
+   tc.maxSamples= maxSamples * pM->nMux;
+   tc.nAcq= tc.nCons= 0;
+   tc.iBus= 0;
+   if (setupThreadCtx(&tc, cfgPB) < 0) { spscRelease(&(tc.ring)); return(-1); }
+   memset(tc.sm, 0, sizeof(tc.sm));
+   timeNow(&(tc.refTS));
+   tc.pCW= NULL;
+   if (captPath && (adsCaptOpen(&cw, captPath, pP, pM, &(tc.refTS)) > 0)) { tc.pCW= &cw; }
+
+   r= pthread_create(th+1, NULL, ads1xConThread, &tc);
+   if (0 == r)
+   {
+      r= pthread_create(th+0, NULL, ads1xAcqThread, &tc);
+      if (0 != r) { ATOMIC_SET(&(tc.acqDone), 1); }
+      else { pthread_join(th[0], NULL); }
+      pthread_join(th[1], NULL);
+   }
+   if (0 != r) { ERROR_CALL("() - pthread_create() -> %d\n", r); r= -1; }
+   else
+   {
+      dt= timeElapsed(&(tc.refTS));
+      report(LOG0,"%d samples, dt= %G sec : mean rate= %G Hz, %d consumed, %u dropped\n", tc.nAcq, dt, tc.nAcq * rcpF(dt), tc.nCons, tc.ring.w.nFail);
+      for (int i=0; i<pM->nMux; i++)
+      {
+         StatResD1R2 sr;
+         statMom1Res1(&sr, tc.sm+i, tc.sm[i].m[0]-1);
+         report(LOG0,"\t[%d] %s : n=%G mean=%G stdev=%G (V)\n", i, ads1xMuxStr(pM->mux[i]), tc.sm[i].m[0], sr.m, sqrt(sr.v));
+      }
+      r= tc.nAcq;
+   }
+   if (tc.pCW) { report(LOG0,"%s : %d blocks\n", captPath, adsCaptClose(tc.pCW)); }
+   spscRelease(&(tc.ring));
+   return(r);
+} // ads1xThreadAcq
+
+
+/***/
+
+// Merge per-bus rings into single time ordered stream: a record is only released
+// once every bus still acquiring has a record pending (so none can be earlier).
+static void *ads1xMergeThread (void *p)
+{
+   ADSMultiBusCtx *pMB= p;
+   U32 live= (1 << pMB->nBus) - 1;
+   RawAGR agr;
+   F32 v;
+
+   while (live)
+   {
+      const ADSSampleRec *pMin= NULL;
+      int iMin= -1, wait= 0;
+      for (int b=0; b<pMB->nBus; b++)
+      {
+         if (live & (1<<b))
+         {
+            ADSThreadCtx *pTC= pMB->tc+b;
+            const int done= ATOMIC_GET(&(pTC->acqDone)); // NB: must precede read
+            const ADSSampleRec *pS= spscReadPtr(&(pTC->ring));
+            if (pS)
+            {
+               if ((NULL == pMin) || timeBefore(&(pS->ts), &(pMin->ts))) { pMin= pS; iMin= b; }
+            }
+            else if (done)
+            {
+               live&= ~(1<<b);
+               if (pTC->acqErr < 0) { WARN_CALL("() - bus %d acquisition failed after %d samples (%d)\n", b, pTC->nAcq, pTC->acqErr); }
+            }
+            else { wait= 1; }
+         }
+      }
+      if (wait || (NULL == pMin))
+      {
+         if (live) { usleep(ADS1X_CON_IDLE_US); }
+      }
+      else
+      {
+         ADSThreadCtx *pTC= pMB->tc+iMin;
+         agr= pMin->agr;
+         convertRawAGR(&v, &agr, 1, pTC->pP);
+         if (agr.flSt & AGR_FLAG_VROK) { statMom1Add(pTC->sm + pMin->iMux, v); }
+         if (pMB->pOut) { fprintf(pMB->pOut, "%.6f\t%u\t%u\t%G\n", timeDiff(&(pMB->refTS), &(pMin->ts)), pMin->iBus, pMin->iMux, v); }
+         spscReadRelease(&(pTC->ring));
+         pTC->nCons++;
+         pMB->nMerged++;
+      }
+   }
+   return(NULL);
+} // ads1xMergeThread
+
+// Create acquisition worker pinned to core iCPU (if >=0) with optional real-time priority
+static int createWorker (pthread_t *pTh, ADSThreadCtx *pTC, const int iCPU, const int fifoPrio)
+{
+   pthread_attr_t attr;
+   int r;
+
+   pthread_attr_init(&attr);
+   if (iCPU >= 0)
+   {
+      cpu_set_t cs;
+      CPU_ZERO(&cs);
+      CPU_SET(iCPU, &cs);
+      pthread_attr_setaffinity_np(&attr, sizeof(cs), &cs);
+   }
+   if (fifoPrio > 0)
+   {
+      struct sched_param sp={0};
+      sp.sched_priority= MIN(fifoPrio, sched_get_priority_max(SCHED_FIFO));
+      pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+      pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+      pthread_attr_setschedparam(&attr, &sp);
+   }
+   r= pthread_create(pTh, &attr, ads1xAcqThread, pTC);
+   if ((EPERM == r) && (fifoPrio > 0))
+   {
+      WARN_CALL("(.. bus %u ..) - SCHED_FIFO not permitted, using default policy\n", pTC->iBus);
+      pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+      r= pthread_create(pTh, &attr, ads1xAcqThread, pTC);
+   }
+   pthread_attr_destroy(&attr);
+   return(r);
+} // createWorker
+
+int ads1xMultiBusAcq
+(
+   const int maxSamples,
+   const LXI2CBusCtx   bc[],
+   const int nBus,
+   const ADSInstProp  *pP,
+   const ADSReadParam *pM,
+   const int fifoPrio,
+   FILE *pOut
+)
+{
+   static ADSMultiBusCtx mb; // NB: static for alignment & stack economy
+   pthread_t th[ADS1X_BUS_MAX+1];
+   U8 made[ADS1X_BUS_MAX]={0}; // NB: pthread_t is opaque, so no "null" handle value
+   const int nCPU= sysconf(_SC_NPROCESSORS_ONLN);
+   U8 cfgPB[ADS1X_NRB];
+   int r, b, nAcq= 0, nDrop= 0;
+   F32 dt;
+
+   if ((maxSamples <= 0) || (nBus <= 0) || (nBus > ADS1X_BUS_MAX)) { return(0); }
+   memset(&mb, 0, sizeof(mb));
+   mb.pOut= pOut;
+   timeNow(&(mb.refTS));
+   for (b=0; b<nBus; b++)
+   {
+      ADSThreadCtx *pTC= mb.tc+b;
+      r= ads1xSyncRate(cfgPB, bc+b, pP->busAddr, ads1xSelectRate(pM->rate[1], pP->hwID));
+      if ((r <= 0) || !spscInit(&(pTC->ring), ADS1X_RING_REC, sizeof(ADSSampleRec))) { break; }
+      pTC->pC= bc+b; pTC->pP= pP; pTC->pM= pM;
+      pTC->refTS= mb.refTS;
+      pTC->maxSamples= maxSamples * pM->nMux;
+      pTC->iBus= b;
+      if (setupThreadCtx(pTC, cfgPB) < 0) { spscRelease(&(pTC->ring)); break; }
+   }
+   mb.nBus= b;
+   if (mb.nBus < nBus) { ERROR_CALL("() - bus %d setup failed\n", b); r= -1; }
+   else
+   {
+      r= pthread_create(th+nBus, NULL, ads1xMergeThread, &mb);
+      if (0 == r)
+      {
+         for (b=0; b<nBus; b++)
+         {  // Cores from 1 (where available) leaving core 0 to consumer & system
+            const int iCPU= (nCPU > 1) ? (1 + b % (nCPU-1)) : -1;
+            if (0 == createWorker(th+b, mb.tc+b, iCPU, fifoPrio)) { made[b]= 1; }
+            else
+            {
+               ERROR_CALL("() - bus %d worker create failed\n", b);
+               ATOMIC_SET(&(mb.tc[b].acqDone), 1);
+            }
+         }
+         for (b=0; b<nBus; b++) { if (made[b]) { pthread_join(th[b], NULL); } }
+         pthread_join(th[nBus], NULL);
+      }
+      else { ERROR_CALL("() - pthread_create() -> %d\n", r); r= -1; }
+   }
+   if (0 == r)
+   {
+      dt= timeElapsed(&(mb.refTS));
+      for (b=0; b<nBus; b++) { nAcq+= mb.tc[b].nAcq; nDrop+= mb.tc[b].ring.w.nFail; }
+      report(LOG0,"%d buses, %d samples, dt= %G sec : aggregate rate= %G Hz, %d merged, %d dropped\n", nBus, nAcq, dt, nAcq * rcpF(dt), mb.nMerged, nDrop);
+      for (b=0; b<nBus; b++)
+      {
+         const ADSThreadCtx *pTC= mb.tc+b;
+         report(LOG0,"\tbus[%d] %d samples (%G Hz)\n", b, pTC->nAcq, pTC->nAcq * rcpF(dt));
+         for (int i=0; i<pM->nMux; i++)
+         {
+            StatResD1R2 sr;
+            statMom1Res1(&sr, pTC->sm+i, pTC->sm[i].m[0]-1);
+            report(LOG0,"\t\t[%d] %s : n=%G mean=%G stdev=%G (V)\n", i, ads1xMuxStr(pM->mux[i]), pTC->sm[i].m[0], sr.m, sqrt(sr.v));
+         }
+      }
+      r= nAcq;
+   }
+   for (b=0; b<mb.nBus; b++) { spscRelease(&(mb.tc[b].ring)); }
+   return(r);
+} // ads1xMultiBusAcq
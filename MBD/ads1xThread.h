@@ -0,0 +1,95 @@
+// Common/MBD/ads1xThread.h - threaded acquisition for TI I2C ADC devices (ADS1xxx series)
+// https://github.com/DrAl-HFS/Common.git
+// Licence: AGPL3
+// (c) Project Contributors Sept 2021
+
+#ifndef ADS1X_THREAD_H
+#define ADS1X_THREAD_H
+
+#include "ads1xAuto.h"
+#include "ads1xCapt.h"
+#include "spscRing.h"
+
+
+/***/
+
+// Capacity (records) of acquisition -> consumer ring
+#define ADS1X_RING_REC (1<<12)
+
+// Record passed from acquisition to consumer thread
+typedef struct
+{
+   RawAGR agr;       // raw result & config
+   U8 iMux, iBus, pad[2];  // index of mux channel within scan & of bus (multi-bus)
+   RawTimeStamp ts;  // sample time
+} ADSSampleRec;
+
+typedef struct
+{
+   SPSCRing ring;    // NB: cache line aligned
+   RawTimeStamp refTS;
+   const LXI2CBusCtx  *pC;
+   const ADSInstProp  *pP;
+   const ADSReadParam *pM;
+   FILE  *pOut;      // Optional per-sample text output (written by consumer)
+   ADSCaptWriter *pCW; // Optional binary capture (written by consumer)
+   AutoExtCtx  aec;  // Acquisition state, set up before the thread starts
+   ADSPredGain pg;   // Predictive gain state (if ADS1X_MODE_PRED)
+   int   maxSamples; // over all mux channels
+   int   acqDone;    // Set (atomic) by acquisition thread on completion
+   int   acqErr;     // Bus error that ended acquisition (valid once acqDone set)
+   int   nAcq, nCons;
+   U8    iBus, pad[3];
+   StatMomD1R2 sm[ADS1X_MUX_MAX]; // Per channel voltage statistics
+} ADSThreadCtx;
+
+#define ADS1X_BUS_MAX (4)
+
+// Multi-bus acquisition: one worker (with its own ring) per bus, single merging consumer
+typedef struct
+{
+   ADSThreadCtx tc[ADS1X_BUS_MAX]; // per bus context (only ring, statistics & counters used by consumer)
+   RawTimeStamp refTS;  // Common time reference
+   FILE  *pOut;
+   int   nBus;
+   int   nMerged;
+} ADSMultiBusCtx;
+
+
+/***/
+
+// Acquisition & consumer thread bodies (pthread compatible), exposed for custom arrangements
+extern void *ads1xAcqThread (void *pTC);
+extern void *ads1xConThread (void *pTC);
+
+// Acquire maxSamples (per mux channel) on a dedicated thread, which never touches
+// stdio or the heap, while conversion, statistics, output & diagnostics run on a
+// second thread. Device setup is completed before either thread starts.
+// Output is optional: text to pOut and/or binary capture to file captPath.
+extern int ads1xThreadAcq
+(
+   const int maxSamples,
+   const LXI2CBusCtx  *pC,
+   const ADSInstProp  *pP,
+   const ADSReadParam *pM,
+   FILE *pOut,
+   const char *captPath
+);
+
+// As above for the same device arrangement on each of nBus buses, acquiring in
+// parallel. Each worker is pinned to its own core (counting from 1, leaving core 0
+// to the consumer, where possible) and scheduled SCHED_FIFO at priority fifoPrio
+// when non-zero (falling back to default policy if not permitted). The consumer
+// merges rings in timestamp order (relative to a common reference) to pOut.
+extern int ads1xMultiBusAcq
+(
+   const int maxSamples,
+   const LXI2CBusCtx   bc[],
+   const int nBus,
+   const ADSInstProp  *pP,
+   const ADSReadParam *pM,
+   const int fifoPrio,
+   FILE *pOut
+);
+
+#endif // ADS1X_THREAD_H
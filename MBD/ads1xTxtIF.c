@@ -25,6 +25,12 @@ U8 scanMap (const U8 id, const U8 map[], const int max)
 
 /***/
 
+const char * ads1xMuxStr (const enum ADS1xMux m)
+{
+   static const char* muxStr[]= {"0/1", "0/3", "1/3", "2/3", "0/G", "1/G", "2/G", "3/G"};
+   return muxStr[ m ];
+} // ads1xMuxStr
+
 int muxMapFromA (U8 m[], int mMax, const char *s, const U8 hwID)
 {
 static const U8 map[ADS1X_MUX_N]={0x01,0x03,0x13,0x23,0x0F,0x1F,0x2F,0x3F};
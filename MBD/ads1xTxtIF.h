@@ -11,6 +11,8 @@
 
 /***/
 
+extern const char * ads1xMuxStr (const enum ADS1xMux m);
+
 extern int muxMapFromA (U8 m[], int mMax, const char *s, const U8 hwID);
 
 
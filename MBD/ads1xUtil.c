@@ -109,7 +109,7 @@ const ADSInstProp * adsInitProp (ADSInstProp *pP, const F32 vdd, const U8 hwID,
    pP->maxUGID= ADS1X_GAIN_0V256;
 #ifdef REPORT_H
    if (hwID & 0xFE) { WARN_CALL("(hwID=0x%02X) - unrecognised\n", hwID); }
-   if (0x48 != (busAddr & 0xFE)) { WARN_CALL("(busAddr=0x%02X) - unrecognised\n", busAddr); }
+   if (0x48 != (busAddr & 0xFC)) { WARN_CALL("(busAddr=0x%02X) - unrecognised\n", busAddr); }
 #endif // REPORT_H
    pP->hwID= hwID;
    pP->busAddr= busAddr;
@@ -122,6 +122,12 @@ static U32 unpackResistance (UEX16 x)
    return scalePowU(UEX_MASK_M & x, 100, x>>UEX_SHIFT);
 } // unpackResistance
 
+F32 adsResDivValue (const ADSResDiv *pRD, const int i)
+{
+   if ((i >= 0) && (i < ADS_RES_DIV_MAX)) { return unpackResistance(pRD->r[i]); }
+   return(0);
+} // adsResDivValue
+
 int adsGetResDiv (F32 r[], const F32 v[], const int n, const ADSResDiv *pRD, const ADSInstProp *pP)
 {
    F32 vlh[2]; // // high / low side sensor config bit ?
@@ -94,4 +94,7 @@ extern const ADSInstProp *adsInitProp (ADSInstProp *pP, const F32 vdd, const U8
 
 extern int adsGetResDiv (F32 r[], const F32 v[], const int n, const ADSResDiv *pRD, const ADSInstProp *pP);
 
+// Fixed resistance (Ohms) of divider for mux channel i
+extern F32 adsResDivValue (const ADSResDiv *pRD, const int i);
+
 #endif // ADS1X_UTIL_H
@@ -0,0 +1,167 @@
+// Common/MBD/ads1xWatch.c - threshold watch (device comparator offload) for TI I2C ADC devices (ADS1xxx series)
+// https://github.com/DrAl-HFS/Common.git
+// Licence: AGPL3
+// (c) Project Contributors Sept 2021
+
+// NB: comparator state is visible only on the ALERT/RDY pin (the config register
+// carries no comparator status) so fallback polling reads the result register,
+// leaving the register pointer in place to require a single 2 byte read per poll.
+
+#include <errno.h>
+#include "ads1xWatch.h"
+
+
+/***/
+
+static I16 voltsToRaw (const F32 v, const F32 rcpScale)
+{
+   const F32 r= v * rcpScale;
+   if (r >= 0x7FFF) { return(0x7FFF); }
+   if (r <= -0x8000) { return(-0x8000); }
+   return(r);
+} // voltsToRaw
+
+static int writeReg (ADSWatchCtx *pW, const U8 reg, const I16 v)
+{
+   U8 rb[ADS1X_NRB];
+   rb[0]= reg;
+   wrI16BE(rb+1, v);
+   pW->nTrans++;
+   return lxi2cWriteRB(pW->pC, pW->busAddr, rb, ADS1X_NRB);
+} // writeReg
+
+static int readRes (ADSWatchCtx *pW, I16 *pV)
+{
+   U8 res[2];
+   int r= lxi2cReadStream(pW->pC, pW->busAddr, res, 2);
+   pW->nTrans++;
+   if (r > 0) { *pV= rdI16BE(res); }
+   return(r);
+} // readRes
+
+// Full readout of watched channel: also clears latched alert
+static int readoutAGR (ADSWatchCtx *pW, RawAGR *pR, RawTimeStamp *pTS)
+{
+   I16 vr= 0;
+   int r= readRes(pW, &vr);
+   if (pTS && (r > 0)) { timeStamp(pTS); }
+   if (pR)
+   {
+      pR->cfgRB0[0]= pW->cfgPB[1];
+      pR->flSt= 0;
+      if (ads1xGetMux(pR->cfgRB0) >= ADS1X_MUX0G) { pR->flSt|= AGR_FLAG_SGND; }
+      pR->res= vr;
+      if (r > 0)
+      {
+         if ((vr >= pW->fsr) || (vr <= -(pW->fsr+1)) || ((vr < 0) && (pR->flSt & AGR_FLAG_SGND))) { pR->flSt|= AGR_FLAG_ORNG; }
+         else { pR->flSt|= AGR_FLAG_VROK; }
+         pR->flSt|= 1;
+      }
+   }
+   return(r);
+} // readoutAGR
+
+
+/***/
+
+int ads1xWatchStart
+(
+   ADSWatchCtx *pW,
+   const ADSInstProp *pP,
+   const ADSWatchParam *pWP,
+   const LXI2CBusCtx *pC,
+   const char *gpioChip,
+   const U16 line,
+   const long pollNS
+)
+{
+   static const U8 cmpID[]={ADS1X_CMP_1, ADS1X_CMP_1, ADS1X_CMP_2, ADS1X_CMP_4, ADS1X_CMP_4};
+   U8 reg[1]={ADS1X_REG_RES};
+   F32 rcpScale;
+   int r;
+
+   memset(pW, 0, sizeof(*pW));
+   pW->alert.fd= -1;
+   pW->pC= pC;
+   pW->busAddr= pP->busAddr;
+   pW->fsr= ads1xRawFSR(pP->hwID);
+   pW->nAssert= MAX(1, MIN(4, pWP->nAssert));
+   pW->pollNS= (pollNS > 0) ? pollNS : ADS1X_WATCH_POLL_NS;
+
+   pW->cfgPB[0]= ADS1X_REG_CFG;
+   ads1xGenCfg(pW->cfgPB+1, pWP->mux, pWP->gainID, pWP->rateID, cmpID[pW->nAssert]);
+   pW->cfgPB[2]|= ADS1X_FL1_CM | ADS1X_FL1_CL; // window, latched, active low (CP=0). MODE=0 -> continuous
+   pW->nAssert= 1 << cmpID[pW->nAssert]; // as programmed (3 -> 4)
+
+   rcpScale= ads1xGainScaleV(pW->cfgPB+1, pP->hwID);
+   if (rcpScale <= 0) { return(-1); }
+   rcpScale= 1.0 / rcpScale;
+   pW->rLo= voltsToRaw(MIN(pWP->vLo, pWP->vHi), rcpScale);
+   pW->rHi= voltsToRaw(MAX(pWP->vLo, pWP->vHi), rcpScale);
+
+   r= writeReg(pW, ADS1X_REG_CLO, pW->rLo);
+   if (r > 0) { r= writeReg(pW, ADS1X_REG_CHI, pW->rHi); }
+   if (r > 0) { r= lxi2cWriteRB(pW->pC, pW->busAddr, pW->cfgPB, ADS1X_NRB); pW->nTrans++; }
+   if (r > 0) { r= lxi2cWriteRB(pW->pC, pW->busAddr, reg, 1); pW->nTrans++; }
+   if (r <= 0) { ERROR_CALL("(.. 0x%02X ..) - setup failed\n", pW->busAddr); return(-1); }
+
+   if (gpioChip)
+   {
+      I16 vr;
+      if (lxgpioOpenEvent(&(pW->alert), gpioChip, line, LX_GPIO_EDGE_FALL, "ads1xWatch") >= 0)
+      {  // Clear any latch asserted during setup (before edge events were armed)
+         readRes(pW, &vr);
+         return(1);
+      }
+      WARN_CALL("() - %s line %u unavailable, polling at %ldms\n", gpioChip, line, pW->pollNS / 1000000);
+   }
+   return(0);
+} // ads1xWatchStart
+
+int ads1xWatchWait (ADSWatchCtx *pW, RawAGR *pR, RawTimeStamp *pTS, const int timeoutMS)
+{
+   if (pW->alert.fd >= 0)
+   {
+      int r= lxgpioWaitEvent(&(pW->alert), timeoutMS, pTS);
+      pW->nWake+= (0 != r);
+      if (r > 0) { r= readoutAGR(pW, pR, pTS); }
+      return(r);
+   }
+   else
+   {  // Fallback: low rate poll of result, applying the same window in software
+      RawTimeStamp next;
+      U64 elapsedNS= 0;
+      timeSetTarget(&next, NULL, pW->pollNS, TIME_MODE_NOW);
+      while ((timeoutMS < 0) || (elapsedNS < (U64)timeoutMS * 1000000))
+      {
+         I16 vr;
+         int r;
+         // Absolute schedule without spinning (cf. timeSpinSleep) so idle cost is a wake-up per poll
+         while (EINTR == clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &next, NULL));
+         timeSetTarget(&next, NULL, pW->pollNS, TIME_MODE_RELATIVE);
+         elapsedNS+= pW->pollNS;
+         pW->nWake++;
+         r= readRes(pW, &vr);
+         if (r <= 0) { return(-1); }
+         if ((vr < pW->rLo) || (vr > pW->rHi))
+         {
+            if (++(pW->nOut) >= pW->nAssert)
+            {
+               pW->nOut= 0;
+               return readoutAGR(pW, pR, pTS);
+            }
+         }
+         else { pW->nOut= 0; }
+      }
+   }
+   return(0);
+} // ads1xWatchWait
+
+int ads1xWatchStop (ADSWatchCtx *pW)
+{
+   lxgpioClose(&(pW->alert));
+   pW->cfgPB[1]= (pW->cfgPB[1] & ~ADS1X_FL0_OS) | ADS1X_FL0_MODE;
+   pW->cfgPB[2]= (pW->cfgPB[2] & ~(ADS1X_FL1_CM|ADS1X_FL1_CL|ADS1X_CMP_M)) | ADS1X_CMP_DISABLE;
+   pW->nTrans++;
+   return lxi2cWriteRB(pW->pC, pW->busAddr, pW->cfgPB, ADS1X_NRB);
+} // ads1xWatchStop
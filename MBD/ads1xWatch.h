@@ -0,0 +1,66 @@
+// Common/MBD/ads1xWatch.h - threshold watch (device comparator offload) for TI I2C ADC devices (ADS1xxx series)
+// https://github.com/DrAl-HFS/Common.git
+// Licence: AGPL3
+// (c) Project Contributors Sept 2021
+
+#ifndef ADS1X_WATCH_H
+#define ADS1X_WATCH_H
+
+#include "ads1xAuto.h"
+#include "lxGPIO.h"
+
+
+/***/
+
+#define ADS1X_WATCH_POLL_NS (100000000) // Default poll interval (10Hz) when ALERT line unavailable
+
+// Watch parameters: single channel, window comparator
+typedef struct
+{
+   F32   vLo, vHi;   // Window limits (Volts): readings outside [vLo,vHi] trigger
+   U8    mux, gainID, rateID;
+   U8    nAssert;    // Consecutive out-of-window conversions required: 1, 2 or 4
+} ADSWatchParam;
+
+typedef struct
+{
+   const LXI2CBusCtx *pC;
+   LXGPIOEvent alert;   // ALERT/RDY line event handle (fd < 0 -> polled)
+   long  pollNS;        // Poll interval (fallback mode)
+   I16   rLo, rHi;      // Thresholds (raw, as programmed)
+   I16   fsr;
+   U8    busAddr;
+   U8    nAssert, nOut; // Consecutive out-of-window readings required & seen (fallback mode)
+   U8    cfgPB[ADS1X_NRB];
+   U32   nWake, nTrans; // Statistics: wake-ups & bus transactions
+} ADSWatchCtx;
+
+
+/***/
+
+// Program thresholds and start continuous conversion with the window comparator
+// asserting (active low, latched) after nAssert out-of-window results. When gpioChip
+// is non-NULL the ALERT/RDY pin (open drain, pull-up required) is monitored on the
+// given line, otherwise (or on failure) the result register is polled at pollNS.
+// Returns 1 when event driven, 0 when polled, <0 on error.
+extern int ads1xWatchStart
+(
+   ADSWatchCtx *pW,
+   const ADSInstProp *pP,
+   const ADSWatchParam *pWP,
+   const LXI2CBusCtx *pC,
+   const char *gpioChip,
+   const U16 line,
+   const long pollNS
+);
+
+// Sleep until the threshold fires (returns 1, with full readout in *pR and
+// timestamp in *pTS), timeout in milliseconds (returns 0, <0 indefinite) or
+// error (<0). The readout clears the latched alert, which re-asserts after
+// further out-of-window conversions (i.e. repeats while the excursion persists).
+extern int ads1xWatchWait (ADSWatchCtx *pW, RawAGR *pR, RawTimeStamp *pTS, const int timeoutMS);
+
+// Disable comparator and return device to single shot (power down) mode
+extern int ads1xWatchStop (ADSWatchCtx *pW);
+
+#endif // ADS1X_WATCH_H
@@ -0,0 +1,69 @@
+// Common/MBD/lxGPIO.c - GPIO character device (edge event) utils for Linux
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+// Linux Ref: https://www.kernel.org/doc/html/latest/userspace-api/gpio/chardev.html
+// NB: uses the (v1) line event ABI for compatibility with older (e.g. RPi) kernels
+
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+#include "lxGPIO.h"
+
+
+/***/
+
+int lxgpioOpenEvent (LXGPIOEvent *pE, const char chipPath[], const U16 line, const U8 edge, const char label[])
+{
+   struct gpioevent_request req={0,};
+   int fd, r= -1;
+
+   pE->fd= -1;
+   pE->line= line;
+   pE->edge= edge & (LX_GPIO_EDGE_RISE|LX_GPIO_EDGE_FALL);
+   if (0 == pE->edge) { return(-1); }
+   fd= open(chipPath, O_RDONLY);
+   if (fd >= 0)
+   {
+      req.lineoffset= line;
+      req.handleflags= GPIOHANDLE_REQUEST_INPUT;
+      if (pE->edge & LX_GPIO_EDGE_RISE) { req.eventflags|= GPIOEVENT_REQUEST_RISING_EDGE; }
+      if (pE->edge & LX_GPIO_EDGE_FALL) { req.eventflags|= GPIOEVENT_REQUEST_FALLING_EDGE; }
+      if (label) { strncpy(req.consumer_label, label, sizeof(req.consumer_label)-1); }
+      r= ioctl(fd, GPIO_GET_LINEEVENT_IOCTL, &req);
+      close(fd); // line fd persists
+      if (r >= 0) { r= pE->fd= req.fd; }
+   }
+   if (r < 0) { ERROR_CALL("(.. %s, %u ..) - errno=%d\n", chipPath, line, errno); }
+   return(r);
+} // lxgpioOpenEvent
+
+int lxgpioWaitEvent (LXGPIOEvent *pE, const int timeoutMS, RawTimeStamp *pTS)
+{
+   struct pollfd pfd={pE->fd, POLLIN|POLLPRI, 0};
+   struct gpioevent_data ev;
+   int r, n= 0;
+
+   if (pE->fd < 0) { return(-1); }
+   do { r= poll(&pfd, 1, timeoutMS); } while ((r < 0) && (EINTR == errno));
+   if (r <= 0) { return(r); }
+   if (pTS) { timeStamp(pTS); }
+   // Drain queued events (non-blocking check between reads)
+   do
+   {
+      if (read(pE->fd, &ev, sizeof(ev)) != sizeof(ev)) { break; }
+      n++;
+   } while (poll(&pfd, 1, 0) > 0);
+   return(n);
+} // lxgpioWaitEvent
+
+void lxgpioClose (LXGPIOEvent *pE)
+{
+   if (pE->fd >= 0) { close(pE->fd); }
+   pE->fd= -1;
+} // lxgpioClose
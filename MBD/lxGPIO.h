@@ -0,0 +1,49 @@
+// Common/MBD/lxGPIO.h - GPIO character device (edge event) utils for Linux
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#ifndef LX_GPIO_H
+#define LX_GPIO_H
+
+#include "util.h"
+#include "lxTiming.h"
+
+
+/***/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LX_GPIO_EDGE_RISE (1<<0)
+#define LX_GPIO_EDGE_FALL (1<<1)
+
+// Edge event line handle
+typedef struct
+{
+   int fd;     // event fd (<0 when not open)
+   U16 line;   // line offset on chip
+   U8  edge;   // LX_GPIO_EDGE_* requested
+   U8  pad[1];
+} LXGPIOEvent;
+
+
+/***/
+
+// Request edge events for a single input line of a GPIO chip (e.g. "/dev/gpiochip0").
+// Returns event fd (>=0) or <0 on error (pE->fd set -1).
+extern int lxgpioOpenEvent (LXGPIOEvent *pE, const char chipPath[], const U16 line, const U8 edge, const char label[]);
+
+// Block (without spinning) until an edge event or timeout (milliseconds, <0 for indefinite).
+// Returns number of events consumed (>0), 0 on timeout or <0 on error. Wake time is
+// stored to *pTS if non-NULL (NB: kernel event stamp clock varies with version).
+extern int lxgpioWaitEvent (LXGPIOEvent *pE, const int timeoutMS, RawTimeStamp *pTS);
+
+extern void lxgpioClose (LXGPIOEvent *pE);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // LX_GPIO_H
@@ -12,6 +12,7 @@
 #include <linux/i2c-dev.h>
 
 #include "lxI2C.h"
+#include "lxI2CProf.h"
 #include "lxTiming.h"
 
 
@@ -24,6 +25,10 @@
 #endif
 
 #define LX_I2C_TRANS_NM (2) // number of i2c_msg blocks per transaction
+
+#if (LX_I2C_RDWR_MAX > I2C_RDWR_IOCTL_MAX_MSGS)
+#error "LX_I2C_RDWR_MAX exceeds kernel limit"
+#endif
 #define LX_I2C_FLAG_TRACE (1<<4)
 
 // Note: adjacent string concatenation, compiler defined symbol, variadic args
@@ -41,6 +46,140 @@ static LXI2CCtx gCtx={LX_I2C_FLAG_TRACE, }; // {{0,-1},{0,-1}},0,0,};
 
 /***/
 
+int lxi2cClockHz (const int clk)
+{
+   if (clk < 1) { return(100000); } // standard/default I2C clock rate
+   if (clk < 10000) { return(clk*1000); } // assume kHz
+   return(clk);  // assume Hz
+} // lxi2cClockHz
+
+int lxi2cClockEff (const LXI2CBusCtx *pBC) { return((pBC->clkEff > 0) ? pBC->clkEff : pBC->clk); }
+
+long lxi2cTransNS (const LXI2CBusCtx *pBC, const U32 nClk)
+{
+   return(pBC->ovhdNS + (nClk * (F64)NANO_TICKS) / lxi2cClockEff(pBC));
+} // lxi2cTransNS
+
+int lxi2cPoolAlloc (LXI2CBusCtx *pBC, const int nMsg)
+{
+   const int n= (nMsg > 0) ? nMsg : LX_I2C_RDWR_MAX;
+   void *p= NULL;
+
+   if (pBC->pMP) { free(pBC->pMP); pBC->pMP= NULL; }
+   if (0 != posix_memalign(&p, LX_I2C_POOL_ALIGN, sizeof(LXI2CMsgPool) + n * sizeof(struct i2c_msg)))
+   {
+      ERROR_CALL("(.. %d) - posix_memalign() failed\n", n);
+      return(-1);
+   }
+   pBC->pMP= p;
+   pBC->pMP->busy= 0;
+   pBC->pMP->nMsg= n;
+   return(n);
+} // lxi2cPoolAlloc
+
+static int rawRDWR (const LXI2CBusCtx *pBC, struct i2c_msg m[], const int nM)
+{
+   if (NULL == pBC->pBE)
+   {
+      struct i2c_rdwr_ioctl_data d={ m, nM };
+      return ioctl(pBC->fd, I2C_RDWR, &d);
+   }
+   return pBC->pBE->rdwr(pBC, m, nM);
+} // rawRDWR
+
+static int nRecMsg (const U16 len) { return((len > 0) ? (len + LX_I2C_TRC_NB - 1) / LX_I2C_TRC_NB : 1); }
+
+// Capture completed transfer. Records are claimed as a block (atomic) so that
+// concurrent callers on the same bus never interleave within a transfer.
+static void traceRec (LXI2CTrace *pT, const struct i2c_msg m[], const int nM, const int r, const RawTimeStamp *pB, const RawTimeStamp *pE)
+{
+   U32 i, n= 0;
+   for (int j=0; j<nM; j++) { n+= nRecMsg(m[j].len); }
+   i= __atomic_fetch_add(&(pT->iW), n, __ATOMIC_RELAXED);
+   for (int j=0; j<nM; j++)
+   {
+      U16 off= 0;
+      do
+      {
+         LXI2CTrcRec *pR= pT->pR + (i++ & (pT->nRec - 1));
+         const int k= MIN(LX_I2C_TRC_NB, m[j].len - off);
+         pR->sBgn= pB->tv_sec; pR->nsBgn= pB->tv_nsec;
+         pR->sEnd= pE->tv_sec; pR->nsEnd= pE->tv_nsec;
+         pR->r= r;
+         pR->addr= m[j].addr;
+         pR->flags= m[j].flags;
+         pR->len= m[j].len;
+         pR->off= off;
+         pR->iMsg= j;
+         pR->nMsg= nM;
+         if (k > 0) { memcpy(pR->b, m[j].buf + off, k); }
+         off+= LX_I2C_TRC_NB;
+      } while (off < m[j].len);
+   }
+} // traceRec
+
+int lxi2cRDWR (const LXI2CBusCtx *pBC, struct i2c_msg m[], const int nM)
+{
+   if (pBC->pTrc || pBC->pPrf)
+   {
+      RawTimeStamp tb, te;
+      int r, e;
+      timeStamp(&tb);
+      r= rawRDWR(pBC, m, nM);
+      e= errno;
+      timeStamp(&te);
+      if (pBC->pTrc) { traceRec(pBC->pTrc, m, nM, (r < 0) ? -e : r, &tb, &te); }
+      if (pBC->pPrf) { lxi2cProfRec(pBC->pPrf, m, nM, r, &tb, &te); }
+      errno= e;
+      return(r);
+   }
+   return rawRDWR(pBC, m, nM);
+} // lxi2cRDWR
+
+int lxi2cTraceStart (LXI2CBusCtx *pBC, LXI2CTrace *pT, const U32 nRec)
+{
+   U32 n= 1;
+   while ((n < nRec) && (n < (1U<<24))) { n<<= 1; } // power of 2: index wrap consistent
+   pT->iW= 0;
+   pT->nRec= n;
+   pT->pR= (nRec > 0) ? malloc(n * sizeof(LXI2CTrcRec)) : NULL;
+   if (NULL == pT->pR) { pT->nRec= 0; return(-1); }
+   pBC->pTrc= pT;
+   return(n);
+} // lxi2cTraceStart
+
+void lxi2cTraceStop (LXI2CBusCtx *pBC) { pBC->pTrc= NULL; }
+
+int lxi2cTraceDump (const LXI2CTrace *pT, const int clk, const char path[])
+{
+   LXI2CTrcHdr h={ {'I','2','C','T'}, LX_I2C_TRC_VER, sizeof(LXI2CTrcRec), 0, clk };
+   FILE *hF;
+   int n= -1;
+
+   if (NULL == pT->pR) { return(-1); }
+   h.nRec= MIN(pT->iW, pT->nRec);
+   hF= fopen(path, "wb");
+   if (NULL == hF) { ERROR_CALL("(.. %s) - fopen() failed\n", path); return(-1); }
+   if (1 == fwrite(&h, sizeof(h), 1, hF))
+   {
+      if (pT->iW <= pT->nRec) { n= fwrite(pT->pR, sizeof(LXI2CTrcRec), pT->iW, hF); }
+      else
+      {  // wrapped: oldest follows newest
+         const U32 i0= pT->iW & (pT->nRec - 1);
+         n= fwrite(pT->pR + i0, sizeof(LXI2CTrcRec), pT->nRec - i0, hF);
+         n+= fwrite(pT->pR, sizeof(LXI2CTrcRec), i0, hF);
+      }
+   }
+   fclose(hF);
+   return(n);
+} // lxi2cTraceDump
+
+void lxi2cTraceRelease (LXI2CTrace *pT)
+{
+   if (pT->pR) { free(pT->pR); pT->pR= NULL; }
+   pT->nRec= pT->iW= 0;
+} // lxi2cTraceRelease
+
 Bool32 lxi2cOpen (LXI2CBusCtx *pBC, const char devPath[], const int clk)
 {
    struct stat st;
@@ -63,9 +202,16 @@ Bool32 lxi2cOpen (LXI2CBusCtx *pBC, const char devPath[], const int clk)
             LX_TRC1("ioctl(.. I2C_FUNCS ..) -> %d\n", r);
             LX_TRC1("flags=0x%0X (%dbytes)\n", pBC->flags, sizeof(pBC->flags));
          }
-         if (clk < 1) { pBC->clk= 100000; } // standard/default I2C clock rate
-         else if (clk < 10000) { pBC->clk= clk*1000; } // assume kHz
-         else { pBC->clk= clk; }  // assume Hz
+         pBC->clk= lxi2cClockHz(clk);
+         pBC->pBE= NULL;
+         pBC->pBEC= NULL;
+         pBC->pTrc= NULL;
+         pBC->pPrf= NULL;
+         pBC->pMP= NULL;
+         pBC->pPC= NULL;
+         pBC->clkEff= 0;
+         pBC->ovhdNS= 0;
+         if (r >= 0) { lxi2cPoolAlloc(pBC, 0); } // NB: multi-block transfers fall back to per-block without pool
       }
    }
    if (r < 0) { ERROR_CALL("(.. %s) - %d\n", devPath, r); }
@@ -84,14 +230,112 @@ Bool32 lxi2cOpen (LXI2CBusCtx *pBC, const char devPath[], const int clk)
    m[1].buf=    pB;
 #endif
 
+// SMBus routing (see lxi2cPathCalibrate)
+static int calClass (const int nB) { return((nB <= 2) ? nB-1 : ((nB <= 8) ? 2 : 3)); }
+
+static Bool32 viaSMB (const LXI2CBusCtx *pBC, const int w, const int nB)
+{
+   const LXI2CPathCal *pPC= pBC->pPC;
+   return(pPC && (nB >= 1) && (nB <= I2C_SMBUS_BLOCK_MAX) && (NULL == pBC->pTrc) && (NULL == pBC->pPrf) &&
+      (pPC->smb[w] & (1 << calClass(nB))));
+} // viaSMB
+
+static int smbSlave (const LXI2CBusCtx *pBC, const U8 busAddr)
+{
+   LXI2CPathCal *pPC= pBC->pPC;
+   if (pPC->slave != busAddr)
+   {
+      if (ioctl(pBC->fd, I2C_SLAVE, busAddr) < 0) { return(-1); }
+      pPC->slave= busAddr;
+   }
+   return(0);
+} // smbSlave
+
+// As I2C_RDWR equivalents: returns messages transferred
+static int smbReadRB (const LXI2CBusCtx *pBC, const U8 busAddr, U8 regBytes[], const U8 nRB)
+{
+   union i2c_smbus_data d;
+   const int nB= nRB-1;
+   struct i2c_smbus_ioctl_data s={ .read_write= I2C_SMBUS_READ, .command= regBytes[0], .data= &d };
+
+   switch(nB)
+   {
+      case 1 : s.size= I2C_SMBUS_BYTE_DATA; break;
+      case 2 : s.size= I2C_SMBUS_WORD_DATA; break;
+      default : s.size= I2C_SMBUS_I2C_BLOCK_DATA; d.block[0]= nB; break;
+   }
+   if (ioctl(pBC->fd, I2C_SMBUS, &s) < 0) { return(-1); }
+   switch(nB)
+   {
+      case 1 : regBytes[1]= d.byte; break;
+      case 2 : regBytes[1]= d.word & 0xFF; regBytes[2]= d.word >> 8; break; // NB: SMBus word is little endian
+      default : memcpy(regBytes+1, d.block+1, nB); break;
+   }
+   return(2);
+} // smbReadRB
+
+static int smbWriteRB (const LXI2CBusCtx *pBC, const U8 busAddr, const U8 regBytes[], const U8 nRB)
+{
+   union i2c_smbus_data d;
+   const int nB= nRB-1;
+   struct i2c_smbus_ioctl_data s={ .read_write= I2C_SMBUS_WRITE, .command= regBytes[0], .data= &d };
+
+   switch(nB)
+   {
+      case 1 : s.size= I2C_SMBUS_BYTE_DATA; d.byte= regBytes[1]; break;
+      case 2 : s.size= I2C_SMBUS_WORD_DATA; d.word= regBytes[1] | (regBytes[2] << 8); break;
+      default : s.size= I2C_SMBUS_I2C_BLOCK_DATA; d.block[0]= nB; memcpy(d.block+1, regBytes+1, nB); break;
+   }
+   if (ioctl(pBC->fd, I2C_SMBUS, &s) < 0) { return(-1); }
+   return(1);
+} // smbWriteRB
+
+// Read with contiguous prefix register byte
+static int rdwrReadRB (const LXI2CBusCtx *pBC, const U8 busAddr, U8 regBytes[], const U8 nRB)
+{
+   struct i2c_msg m[]= {
+      { .addr= busAddr,  .flags= I2C_M_WR,  .len= 1,  .buf= regBytes },
+      { .addr= busAddr,  .flags= I2C_M_RD,  .len= nRB-1,  .buf= regBytes+1 } };
+   return lxi2cRDWR(pBC, m, 2);
+} // rdwrReadRB
+
+static int rdwrWriteRB (const LXI2CBusCtx *pBC, const U8 busAddr, const U8 regBytes[], const U8 nRB)
+{
+   struct i2c_msg m= { .addr= busAddr,  .flags= I2C_M_WR,  .len= nRB,  .buf= (void*)regBytes };
+   return lxi2cRDWR(pBC, &m, 1);
+} // rdwrWriteRB
+
+// Address select & transfer under lock, falling back to I2C_RDWR if address select fails
+static int smbRouteRB (const LXI2CBusCtx *pBC, const U8 busAddr, U8 regBytes[], const U8 nRB, const int w)
+{
+   LXI2CPathCal *pPC= pBC->pPC;
+   int r;
+
+   pthread_mutex_lock(&(pPC->lock));
+   r= smbSlave(pBC, busAddr);
+   if (r >= 0) { r= w ? smbWriteRB(pBC, busAddr, regBytes, nRB) : smbReadRB(pBC, busAddr, regBytes, nRB); }
+   else { r= -2; }
+   pthread_mutex_unlock(&(pPC->lock));
+   if (-2 == r) { r= w ? rdwrWriteRB(pBC, busAddr, regBytes, nRB) : rdwrReadRB(pBC, busAddr, regBytes, nRB); }
+   return(r);
+} // smbRouteRB
+
 // Explicit register byte for external API compatibility
 int lxi2cReadReg (const LXI2CBusCtx *pBC, const U8 busAddr, U8 regCmd, U8 b[], const U8 nB)
 {
+   if (viaSMB(pBC, 0, nB))
+   {
+      U8 rb[1+I2C_SMBUS_BLOCK_MAX];
+      int r;
+      rb[0]= regCmd;
+      r= smbRouteRB(pBC, busAddr, rb, 1+nB, 0);
+      if (r >= 0) { memcpy(b, rb+1, nB); }
+      return(r);
+   }
    struct i2c_msg m[]= {
       { .addr= busAddr,  .flags= I2C_M_WR,  .len= 1,  .buf= &regCmd },
       { .addr= busAddr,  .flags= I2C_M_RD,  .len= nB,  .buf= b } };
-   struct i2c_rdwr_ioctl_data d={ m, 2 };
-   return ioctl(pBC->fd, I2C_RDWR, &d);
+   return lxi2cRDWR(pBC, m, 2);
 } // lxi2cReadReg
 
 int lxi2cWriteReg (const LXI2CBusCtx *pBC, const U8 busAddr, U8 regCmd, const U8 b[], const U8 nB)
@@ -109,8 +353,7 @@ int lxi2cWriteReg (const LXI2CBusCtx *pBC, const U8 busAddr, U8 regCmd, const U8
    struct i2c_msg m[]= {
       { .addr= busAddr,  .flags= I2C_M_WR,  .len= 1,  .buf= &regCmd },
       { .addr= busAddr,  .flags= I2C_M_WR | I2C_M_NOSTART,  .len= nB,  .buf= (void*)b } };
-   struct i2c_rdwr_ioctl_data d={ m, 2 };
-   return ioctl(pBC->fd, I2C_RDWR, &d);
+   return lxi2cRDWR(pBC, m, 2);
 #endif
 } // lxi2cWriteReg
 
@@ -119,50 +362,83 @@ int lxi2cReadStream (const LXI2CBusCtx *pBC, const U8 busAddr, U8 b[], const U16
 {
    struct i2c_msg m[]= {
       { .addr= busAddr,  .flags= I2C_M_RD,  .len= nB,  .buf= b } };
-   struct i2c_rdwr_ioctl_data d={ m, 1 };
-   return ioctl(pBC->fd, I2C_RDWR, &d);
+   return lxi2cRDWR(pBC, m, 1);
 } // lxi2cReadStream
 
-// Read with contiguous prefix register byte
 int lxi2cReadRB (const LXI2CBusCtx *pBC, const U8 busAddr, U8 regBytes[], const U8 nRB)
 {
-   struct i2c_msg m[]= {
-      { .addr= busAddr,  .flags= I2C_M_WR,  .len= 1,  .buf= regBytes },
-      { .addr= busAddr,  .flags= I2C_M_RD,  .len= nRB-1,  .buf= regBytes+1 } };
-   struct i2c_rdwr_ioctl_data d={ m, 2 };
-   return ioctl(pBC->fd, I2C_RDWR, &d);
+   if (viaSMB(pBC, 0, nRB-1)) { return smbRouteRB(pBC, busAddr, regBytes, nRB, 0); }
+   return rdwrReadRB(pBC, busAddr, regBytes, nRB);
 } // lxi2cReadRB
 
 int lxi2cWriteRB (const LXI2CBusCtx *pBC, const U8 busAddr, const U8 regBytes[], const U8 nRB)
 {
-   struct i2c_msg m= { .addr= busAddr,  .flags= I2C_M_WR,  .len= nRB,  .buf= (void*)regBytes };
-   struct i2c_rdwr_ioctl_data d={ &m, 1 };
-   return ioctl(pBC->fd, I2C_RDWR, &d);
+   if (viaSMB(pBC, 1, nRB-1)) { return smbRouteRB(pBC, busAddr, (U8*)regBytes, nRB, 1); }
+   return rdwrWriteRB(pBC, busAddr, regBytes, nRB);
 } // lxi2cWriteRB
 
-#define MRBYTES (2 * sizeof(struct i2c_msg))
+// Read with prefix register byte then write a (different) register packet, all
+// within a single transaction. Suits pipelined operation e.g. fetch a result
+// and start the next conversion without an intervening system call.
+int lxi2cReadWriteRB (const LXI2CBusCtx *pBC, const U8 busAddr, U8 rdRB[], const U8 nRdRB, const U8 wrRB[], const U8 nWrRB)
+{
+   struct i2c_msg m[]= {
+      { .addr= busAddr,  .flags= I2C_M_WR,  .len= 1,  .buf= rdRB },
+      { .addr= busAddr,  .flags= I2C_M_RD,  .len= nRdRB-1,  .buf= rdRB+1 },
+      { .addr= busAddr,  .flags= I2C_M_WR,  .len= nWrRB,  .buf= (void*)wrRB } };
+   return lxi2cRDWR(pBC, m, 3);
+} // lxi2cReadWriteRB
+
+// Claim bus message pool, else aligned caller workspace, returning capacity in *pN
+static struct i2c_msg *msgClaim (int *pN, const LXI2CBusCtx *pBC, const MemBuff *pWS)
+{
+   LXI2CMsgPool *pMP= pBC->pMP;
+   if (pMP && (0 == __atomic_exchange_n(&(pMP->busy), 1, __ATOMIC_ACQUIRE))) { *pN= pMP->nMsg; return(pMP->m); }
+   if (validMemBuff(pWS, sizeof(struct i2c_msg)) && (0 == ((size_t)(pWS->p) % __alignof__(struct i2c_msg))))
+   {
+      *pN= pWS->bytes / sizeof(struct i2c_msg);
+      return(pWS->p);
+   }
+   *pN= 0;
+   return(NULL);
+} // msgClaim
+
+static void msgRelease (const LXI2CBusCtx *pBC, const struct i2c_msg *pM)
+{
+   if (pBC->pMP && (pM == pBC->pMP->m)) { __atomic_store_n(&(pBC->pMP->busy), 0, __ATOMIC_RELEASE); }
+} // msgRelease
+
 int lxi2cReadMultiRB (const LXI2CBusCtx *pBC, const MemBuff *pWS, const U8 busAddr, U8 regBytes[], const U8 nRB, const U8 nM)
 {
-   int offset= 0, r= 0;
-   if (validMemBuff(pWS, nM * MRBYTES))
+   int nP, offset= 0, r= 0;
+   struct i2c_msg *pM= msgClaim(&nP, pBC, pWS);
+   const int nT= nP / 2; // blocks per transfer
+
+   if (nT > 0)
    {
-      struct i2c_rdwr_ioctl_data d={ pWS->p, 2 * nM }; // NB: alignment assumed
-      for (int i= 0; i<nM; i++)
+      for (int i= 0; (i < nM) && (r >= 0); )
       {
-         int j= 2*i;
-         d.msgs[j].addr=   busAddr;
-         d.msgs[j].flags=  I2C_M_WR;
-         d.msgs[j].len=    1;
-         d.msgs[j].buf=    regBytes+offset;
+         const int k= MIN(nT, nM - i);
+         int t;
+         for (int j= 0; j<2*k; j+= 2)
+         {
+            pM[j].addr=    busAddr;
+            pM[j].flags=   I2C_M_WR;
+            pM[j].len=     1;
+            pM[j].buf=     regBytes+offset;
 
-         d.msgs[j+1].addr= busAddr;
-         d.msgs[j+1].flags= I2C_M_RD;
-         d.msgs[j+1].len=  nRB-1;
-         d.msgs[j+1].buf=  regBytes+offset+1;
+            pM[j+1].addr=  busAddr;
+            pM[j+1].flags= I2C_M_RD;
+            pM[j+1].len=   nRB-1;
+            pM[j+1].buf=   regBytes+offset+1;
 
-         offset+= nRB;
+            offset+= nRB;
+         }
+         t= lxi2cRDWR(pBC, pM, 2*k);
+         if (t < 0) { r= t; } else { r+= t; }
+         i+= k;
       }
-      return ioctl(pBC->fd, I2C_RDWR, &d);
+      msgRelease(pBC, pM);
    }
    else
    {
@@ -175,23 +451,31 @@ int lxi2cReadMultiRB (const LXI2CBusCtx *pBC, const MemBuff *pWS, const U8 busAd
    return(r);
 } // lxi2cReadMultiRB
 
-#define MWBYTES sizeof(struct i2c_msg)
 int lxi2cWriteMultiRB (const LXI2CBusCtx *pBC, const MemBuff *pWS, const U8 busAddr, const U8 regBytes[], const U8 nRB, const U8 nM)
 {
-   int offset= 0, r=0;
-   if (validMemBuff(pWS, nM * MWBYTES))
+   int nP, offset= 0, r= 0;
+   struct i2c_msg *pM= msgClaim(&nP, pBC, pWS);
+
+   if (nP > 0)
    {
-      struct i2c_rdwr_ioctl_data d={ pWS->p, nM }; // NB: alignment assumed
-      for (int i= 0; i<nM; i++)
+      for (int i= 0; (i < nM) && (r >= 0); )
       {
-         d.msgs[i].addr=   busAddr;
-         d.msgs[i].flags=  I2C_M_WR;
-         d.msgs[i].len=    nRB;
-         d.msgs[i].buf=    (void*)(regBytes+offset);
+         const int k= MIN(nP, nM - i);
+         int t;
+         for (int j= 0; j<k; j++)
+         {
+            pM[j].addr=    busAddr;
+            pM[j].flags=   I2C_M_WR;
+            pM[j].len=     nRB;
+            pM[j].buf=     (void*)(regBytes+offset);
 
-         offset+= nRB;
+            offset+= nRB;
+         }
+         t= lxi2cRDWR(pBC, pM, k);
+         if (t < 0) { r= t; } else { r+= t; }
+         i+= k;
       }
-      return ioctl(pBC->fd, I2C_RDWR, &d);
+      msgRelease(pBC, pM);
    }
    else
    {
@@ -204,6 +488,68 @@ int lxi2cWriteMultiRB (const LXI2CBusCtx *pBC, const MemBuff *pWS, const U8 busA
    return(r);
 } // lxi2cWriteMultiRB
 
+void lxi2cBatchReset (LXI2CBatch *pB) { pB->nM= pB->nE= pB->nIoctl= pB->nDone= 0; }
+
+static int batchAdd (LXI2CBatch *pB, const U8 nMsg, const struct i2c_msg m[])
+{
+   if ((pB->nM + nMsg) > LX_I2C_BATCH_CAP) { return(-1); }
+   for (int i=0; i<nMsg; i++)
+   {
+      pB->m[pB->nM+i]= m[i];
+      pB->first[pB->nM+i]= (0 == i);
+   }
+   pB->nM+= nMsg;
+   return(pB->nE++);
+} // batchAdd
+
+int lxi2cBatchReadRB (LXI2CBatch *pB, const U8 busAddr, U8 regBytes[], const U8 nRB)
+{
+   const struct i2c_msg m[]= {
+      { .addr= busAddr,  .flags= I2C_M_WR,  .len= 1,  .buf= regBytes },
+      { .addr= busAddr,  .flags= I2C_M_RD,  .len= nRB-1,  .buf= regBytes+1 } };
+   return batchAdd(pB, 2, m);
+} // lxi2cBatchReadRB
+
+int lxi2cBatchWriteRB (LXI2CBatch *pB, const U8 busAddr, const U8 regBytes[], const U8 nRB)
+{
+   const struct i2c_msg m= { .addr= busAddr,  .flags= I2C_M_WR,  .len= nRB,  .buf= (void*)regBytes };
+   return batchAdd(pB, 1, &m);
+} // lxi2cBatchWriteRB
+
+int lxi2cBatchReadStream (LXI2CBatch *pB, const U8 busAddr, U8 b[], const U16 nB)
+{
+   const struct i2c_msg m= { .addr= busAddr,  .flags= I2C_M_RD,  .len= nB,  .buf= b };
+   return batchAdd(pB, 1, &m);
+} // lxi2cBatchReadStream
+
+int lxi2cBatchExec (const LXI2CBusCtx *pBC, LXI2CBatch *pB)
+{
+   int i= 0, n= 0, r= 0;
+   pB->nIoctl= pB->nDone= 0;
+   while (i < pB->nM)
+   {
+      struct i2c_rdwr_ioctl_data d={ pB->m+i, pB->nM-i };
+      int nE= 0;
+      if (d.nmsgs > LX_I2C_RDWR_MAX)
+      {  // back off to entry boundary
+         d.nmsgs= LX_I2C_RDWR_MAX;
+         while ((d.nmsgs > 1) && !pB->first[i + d.nmsgs]) { d.nmsgs--; }
+      }
+      for (int j=0; j<d.nmsgs; j++) { nE+= (0 != pB->first[i+j]); }
+      r= lxi2cRDWR(pBC, d.msgs, d.nmsgs);
+      pB->nIoctl++;
+      if (r < 0)
+      {
+         ERROR_CALL("() - ioctl() for entries %d..%d -> %d\n", pB->nDone, pB->nDone + nE - 1, r);
+         return(r);
+      }
+      pB->nDone+= nE;
+      n+= r;
+      i+= d.nmsgs;
+   }
+   return(n);
+} // lxi2cBatchExec
+
 #ifdef LX_I2C_DUMP // FINAL DEPRECATION
 #define TRANS_WRITE_MAX 15
 int lxi2cTrans (const LXI2CBusCtx *pBC, const U16 busAddr, const U16 f, U16 nB, U8 *pB, U8 reg)
@@ -230,7 +576,7 @@ int lxi2cTrans (const LXI2CBusCtx *pBC, const U16 busAddr, const U16 f, U16 nB,
       m[0].len= 1+nB;
       d.nmsgs= 1;
    }
-   int r= ioctl(pBC->fd, I2C_RDWR, &d);
+   int r= lxi2cRDWR(pBC, d.msgs, d.nmsgs);
    if ((I2C_M_RD & f) && (gCtx.flags & LX_I2C_FLAG_TRACE))
    {
       const U8 gTEC[2]={TRC1,ERR0};
@@ -290,8 +636,163 @@ int lxi2cTransSMBUS (const LXI2CBusCtx *pBC, const U16 f, U16 nB, U8 *pB, U8 reg
    return(r);
 } // lxi2cTransSMBUS
 
+static const U8 gCalNB[LX_I2C_CAL_NSZ]={1,2,4,16}; // Representative payload per size class
+
+static int cmpU32 (const void *pA, const void *pB)
+{
+   const U32 a= *(const U32*)pA, b= *(const U32*)pB;
+   return((a > b) - (a < b));
+} // cmpU32
+
+#define CAL_RDWR  (0)
+#define CAL_SMB   (1)
+#define CAL_AUTO  (2)   // As routed
+
+// Median transfer time via path (0 on failure)
+static U32 calMeasure (const LXI2CBusCtx *pBC, const U8 busAddr, U8 rb[], const U8 nRB, const int w, const int path)
+{
+   U32 t[LX_I2C_CAL_ITER];
+   for (int i=0; i<LX_I2C_CAL_ITER; i++)
+   {
+      RawTimeStamp t0, t1;
+      int r;
+      timeStamp(&t0);
+      switch(path)
+      {
+         case CAL_SMB : r= smbRouteRB(pBC, busAddr, rb, nRB, w); break;
+         case CAL_RDWR : r= w ? rdwrWriteRB(pBC, busAddr, rb, nRB) : rdwrReadRB(pBC, busAddr, rb, nRB); break;
+         default : r= w ? lxi2cWriteRB(pBC, busAddr, rb, nRB) : lxi2cReadRB(pBC, busAddr, rb, nRB); break;
+      }
+      timeStamp(&t1);
+      if (r < 0) { return(0); }
+      t[i]= timeDiffNS(&t0, &t1);
+   }
+   qsort(t, LX_I2C_CAL_ITER, sizeof(t[0]), cmpU32);
+   return MAX(1, t[LX_I2C_CAL_ITER>>1]);
+} // calMeasure
+
+int lxi2cPathCalibrate (LXI2CBusCtx *pBC, const U8 busAddr, const U8 reg, const U8 flags)
+{
+   static const UL funcSMB[2][LX_I2C_CAL_NSZ]=
+   {
+      { I2C_FUNC_SMBUS_READ_BYTE_DATA, I2C_FUNC_SMBUS_READ_WORD_DATA, I2C_FUNC_SMBUS_READ_I2C_BLOCK, I2C_FUNC_SMBUS_READ_I2C_BLOCK },
+      { I2C_FUNC_SMBUS_WRITE_BYTE_DATA, I2C_FUNC_SMBUS_WRITE_WORD_DATA, I2C_FUNC_SMBUS_WRITE_I2C_BLOCK, I2C_FUNC_SMBUS_WRITE_I2C_BLOCK }
+   };
+   LXI2CPathCal *pPC= pBC->pPC;
+   U8 rb[1+I2C_SMBUS_BLOCK_MAX];
+   Bool32 smbOK;
+   int n= 0;
+
+   if (NULL == pPC)
+   {
+      pPC= malloc(sizeof(*pPC));
+      if (NULL == pPC) { return(-1); }
+      pthread_mutex_init(&(pPC->lock), NULL);
+   }
+   pthread_mutex_lock(&(pPC->lock));
+   memset(pPC->nsRDWR, 0, sizeof(pPC->nsRDWR));
+   memset(pPC->nsSMB, 0, sizeof(pPC->nsSMB));
+   pPC->smb[0]= pPC->smb[1]= 0;
+   pPC->slave= -1;
+   pBC->pPC= pPC; // NB: routing disabled (smb[] clear) during measurement
+   smbOK= (NULL == pBC->pBE) && (pBC->fd >= 0) && (smbSlave(pBC, busAddr) >= 0);
+   pthread_mutex_unlock(&(pPC->lock));
+
+   for (int c=0; c<LX_I2C_CAL_NSZ; c++)
+   {
+      const U8 nRB= 1+gCalNB[c];
+      rb[0]= reg;
+      pPC->nsRDWR[0][c]= calMeasure(pBC, busAddr, rb, nRB, 0, CAL_RDWR);
+      if (0 == pPC->nsRDWR[0][c]) { continue; } // device not responding (or register range too short)
+      for (int w=0; w<=((flags & LX_I2C_CAL_WRITE) ? 1 : 0); w++)
+      {
+         if (w) { pPC->nsRDWR[1][c]= calMeasure(pBC, busAddr, rb, nRB, 1, CAL_RDWR); }
+         if (smbOK && (pBC->flags & funcSMB[w][c])) { pPC->nsSMB[w][c]= calMeasure(pBC, busAddr, rb, nRB, w, CAL_SMB); }
+      }
+   }
+   if (0 == pPC->nsRDWR[0][0]) { ERROR_CALL("(.. 0x%02X ..) - no response\n", busAddr); return(-1); }
+   // Prefer I2C_RDWR (traceable, batched) unless SMBus at least ~6% faster
+   for (int w=0; w<2; w++)
+   {
+      for (int c=0; c<LX_I2C_CAL_NSZ; c++)
+      {
+         const U32 tR= pPC->nsRDWR[w][c], tS= pPC->nsSMB[w][c];
+         if ((tR > 0) && (tS > 0) && (tS < (tR - (tR >> 4)))) { pPC->smb[w]|= 1 << c; n++; }
+      }
+   }
+   return(n);
+} // lxi2cPathCalibrate
+
+int lxi2cClockCalibrate (LXI2CBusCtx *pBC, const U8 busAddr, const U8 reg)
+{
+   static const U8 nB[]={1,2,4,8,16,32};
+   const int n= sizeof(nB);
+   U8 rb[1+32];
+   F64 sX=0, sY=0, sXX=0, sXY=0, d, b;
+
+   for (int i=0; i<n; i++)
+   {
+      const F64 x= I2C_ADDR_BITS_NCLK(8,8) + I2C_ADDR_BITS_NCLK(8, 8*nB[i]); // register write + read
+      F64 y;
+      rb[0]= reg;
+      y= calMeasure(pBC, busAddr, rb, 1+nB[i], 0, CAL_AUTO);
+      if (0 == y) { ERROR_CALL("(.. 0x%02X ..) - no response\n", busAddr); return(-1); }
+      sX+= x; sY+= y; sXX+= x * x; sXY+= x * y;
+   }
+   d= n * sXX - sX * sX;
+   b= (d > 0) ? (n * sXY - sX * sY) / d : 0; // ns per clock
+   if (b <= 0) { ERROR_CALL("(.. 0x%02X ..) - fit failed\n", busAddr); return(-1); }
+   pBC->clkEff= NANO_TICKS / b + 0.5;
+   pBC->ovhdNS= MAX(0, (sY - b * sX) / n);
+   if ((pBC->clkEff < (pBC->clk >> 1)) || (pBC->clkEff > (pBC->clk << 1)))
+   {
+      WARN_CALL("() - effective clock %dHz vs nominal %dHz\n", pBC->clkEff, pBC->clk);
+   }
+   return(pBC->clkEff);
+} // lxi2cClockCalibrate
+
+void lxi2cPathDump (const LXI2CBusCtx *pBC, const U8 reportID)
+{
+   static const char *dirS[]={"read","write"}, *szS[]={"1","2","3-8","9-32"};
+   const LXI2CPathCal *pPC= pBC->pPC;
+
+   if (NULL == pPC) { report(reportID, "%s\n", "I2C path: not calibrated (I2C_RDWR)"); return; }
+   report(reportID, "I2C path: median us per transfer (I2C_RDWR / SMBus), adapter SMBus %s\n",
+      (NULL == pBC->pBE) ? "available" : "n/a (backend)");
+   for (int w=0; w<2; w++)
+   {
+      for (int c=0; c<LX_I2C_CAL_NSZ; c++)
+      {
+         const U32 tR= pPC->nsRDWR[w][c], tS= pPC->nsSMB[w][c];
+         if (tR > 0)
+         {
+            report(reportID, "\t%5s %4sB : %8.1f / ", dirS[w], szS[c], 1E-3 * tR);
+            if (tS > 0) { report(reportID, "%8.1f", 1E-3 * tS); } else { report(reportID, "%8s", "-"); }
+            report(reportID, " -> %s\n", (pPC->smb[w] & (1 << c)) ? "SMBus" : "I2C_RDWR");
+         }
+      }
+   }
+} // lxi2cPathDump
+
 void lxi2cClose (LXI2CBusCtx *pC)
 {
+   if (pC->pPC)
+   {
+      pthread_mutex_destroy(&(pC->pPC->lock));
+      free(pC->pPC);
+      pC->pPC= NULL;
+   }
+   if (pC->pMP)
+   {
+      free(pC->pMP);
+      pC->pMP= NULL;
+   }
+   if (pC->pBE)
+   {
+      if (pC->pBE->close) { pC->pBE->close(pC); }
+      pC->pBE= NULL;
+      pC->pBEC= NULL;
+   }
    if (pC->fd >= 0)
    {
       close(pC->fd);
@@ -435,7 +936,7 @@ int lxi2cPing (const LXI2CBusCtx *pC, U8 busAddr, const LXI2CPing *pP, U8 modeFl
    do
    {
       pS->rT= timeSpinWaitUntil(ts+2, ts+1);
-      pS->rIO= ioctl(pC->fd, I2C_RDWR, &d);
+      pS->rIO= lxi2cRDWR(pC, d.msgs, d.nmsgs);
       pS->nE+= (1 != pS->rIO);
       pS->rT= timeSetTarget(ts+1, ts+1, pP->ivlNanoSec, TIME_MODE_RELATIVE);
    } while ((++(pS->nP) < pS->maxP) && (pS->nE <= pP->maxErr));
@@ -470,22 +971,35 @@ int hack (const LXI2CBusCtx *pC, U8 busAddr)
 
 /*** ARG HANDLING FOR STANDALONE BUILD (PING) ***/
 
-#define ARG_ACTION 0xF0  // Mask
+#include "lxI2CBench.h"
+#include "lxI2CSim.h"
+#include "lxI2CSched.h"
+#include "lxI2CAsync.h"
+
+#define ARG_ACTION 0x17F0  // Mask
+#define ARG_ASYNC  (1<<12)
+#define ARG_CAL    (1<<10)
+#define ARG_SCHED  (1<<9)
+#define ARG_BENCH  (1<<8)
 #define ARG_PING   (1<<7)
 #define ARG_DUMP   (1<<6)
 #define ARG_XPT    (1<<5) // hack1 ?
 #define ARG_HACK   (1<<4)
 
-#define ARG_OPTION   0x0F  // Mask
+#define ARG_OPTION   0x080F  // Mask
+#define ARG_CALWR   (1<<11)
+#define ARG_SIM     (1<<3)
+#define ARG_JSON    (1<<2)
 #define ARG_HELP    (1<<1)
 #define ARG_VERBOSE (1<<0)
 
 typedef struct
 {
    LXI2CPing ping;
+   LXI2CBenchParam bench;
    char devPath[14]; // host device path
    U8 busAddr; // bus device address
-   U8 flags;
+   U16 flags;
 } LXI2CArgs;
 
 static LXI2CArgs gArgs=
@@ -494,13 +1008,14 @@ static LXI2CArgs gArgs=
       1000, 10, // n, e
       1000000  // interval (ns)
    },
+   {  {0}, 0 }, // bench: lxi2cBenchDefault() in main()
    "/dev/i2c-1", -1, 0
 };
 
 void pingUsageMsg (const char name[])
 {
-static const char optCh[]="abcdetPDXHvh";
-static const char argCh[]="######     ";
+static const char optCh[]="abcdetkrBEAKWPDXHSJvh";
+static const char argCh[]="########             ";
 static const char *desc[]=
 {
    "I2C bus address: 2digit hex (no prefix)",
@@ -509,10 +1024,19 @@ static const char *desc[]=
    "device index (-> path /dev/i2c-# )",
    "maximum errors to ignore (-1 -> all)",
    "interval (nanoseconds) between messages",
+   "benchmark shapes: hex mask 1=write 2=read 4=wrrd 8=multi",
+   "benchmark register (2digit hex)",
+   "Benchmark (sweep payload 1..32 bytes, -c iterations per point)",
+   "EDF schedule demo: ADS scan 2ms, UBX drain 100ms, LED frame 60Hz (2sec)",
+   "Async engine demo: ADS, UBX & LED clients plus absent device (coalescing, failure isolation, drain on stop)",
+   "Kalibrate register access path (I2C_RDWR vs SMBus) & effective clock at -a address, -r register",
+   "Write calibration also (register content written back)",
    "Ping",
    "Dump",
    "eXperimental",
    "Hack",
+   "Simulated bus (ADS1x15 at -a address, BNO08x for -X, no hardware required)",
+   "JSON benchmark output (default CSV)",
    "verbose diagnostic messages",
    "help (display this text)"
 };
@@ -526,7 +1050,7 @@ static const char *desc[]=
 
 void argDump (LXI2CArgs *pP)
 {
-   report(OUT,"Device: devPath=%s, busAddr=%02X, Flags=%02X\n", pP->devPath, pP->busAddr, pP->flags);
+   report(OUT,"Device: devPath=%s, busAddr=%02X, Flags=%03X\n", pP->devPath, pP->busAddr, pP->flags);
    report(OUT,"\tmaxIter=%d, maxErr=%d\n", pP->ping.maxIter, pP->ping.maxErr);
    report(OUT,"\tb[%d]={", pP->ping.nB); reportBytes(OUT, pP->ping.b, pP->ping.nB);
    report(OUT,"}\n\tinterval=");
@@ -544,7 +1068,7 @@ void i2cArgTrans (LXI2CArgs *pA, int argc, char *argv[])
    signed char ch;
    do
    {
-      ch= getopt(argc,argv,"a:b:c:d:e:t:PDXHvh");
+      ch= getopt(argc,argv,"a:b:c:d:e:t:k:r:BEAKWPDXHSJvh");
       if (ch > 0)
       {
          switch(ch)
@@ -560,6 +1084,7 @@ void i2cArgTrans (LXI2CArgs *pA, int argc, char *argv[])
             case 'c' :
                sscanf(optarg, "%d", &t);
                pA->ping.maxIter= t;
+               if (t > 0) { pA->bench.nIter= t; }
                break;
             case 'd' :
                ch= optarg[0];
@@ -580,10 +1105,25 @@ void i2cArgTrans (LXI2CArgs *pA, int argc, char *argv[])
                if (t > 0) { pA->ping.ivlNanoSec= t; }
                break;
             }
+            case 'k' :
+               sscanf(optarg, "%x", &t);
+               if ((t & LX_I2C_BENCH_ALL) == t) { pA->bench.shapes= t; }
+               break;
+            case 'r' :
+               sscanf(optarg, "%x", &t);
+               if ((t & 0xFF) == t) { pA->bench.reg= t; }
+               break;
+            case 'B' : pA->flags|= ARG_BENCH; break;
+            case 'E' : pA->flags|= ARG_SCHED; break;
+            case 'A' : pA->flags|= ARG_ASYNC; break;
+            case 'K' : pA->flags|= ARG_CAL; break;
+            case 'W' : pA->flags|= ARG_CALWR; break;
             case 'P' : pA->flags|= ARG_PING; break;
             case 'D' : pA->flags|= ARG_DUMP; break;
             case 'X' : pA->flags|= ARG_XPT; break;
             case 'H' : pA->flags|= ARG_HACK; break;
+            case 'S' : pA->flags|= ARG_SIM; break;
+            case 'J' : pA->flags|= ARG_JSON; break;
             //case 'R' : pA->flags|= ARG_READ; break;
             //case 'W' : pA->flags|= ARG_WRITE; break; // TODO: Require payload
             //
@@ -599,6 +1139,7 @@ void i2cArgTrans (LXI2CArgs *pA, int argc, char *argv[])
    if (pA->flags & ARG_HELP) { pingUsageMsg(argv[0]); }
    // disable processing if only help/verbose specified
    // otherwise add default action if necessary
+   if (pA->flags & ARG_JSON) { pA->bench.fmt= LX_I2C_BENCH_JSON; }
    if (n[1] >= n[0]) { pA->flags&= ARG_OPTION; }
    else if (0 == (pA->flags & ARG_ACTION)) { pA->flags|= ARG_PING; }
 } // i2cArgTrans
@@ -618,19 +1159,152 @@ U8 defBA (U8 a, U8 d)
 
 static LXI2CBusCtx gBusCtx={0,-1};
 
+// Schedule demo jobs: context is device bus address
+static int adsScanJob (const LXI2CBusCtx *pC, void *pCtx)
+{
+   U8 rb[3]= {0x00,};   // Conversion register
+   return lxi2cReadRB(pC, (U8)(size_t)pCtx, rb, 3);
+} // adsScanJob
+
+static int ubxDrainJob (const LXI2CBusCtx *pC, void *pCtx)
+{
+   const U8 busAddr= (size_t)pCtx;
+   U8 b[256];
+   int r;
+   b[0]= 0xFD; // byte count (big endian) then data stream
+   r= lxi2cReadRB(pC, busAddr, b, 3);
+   if (r >= 0)
+   {
+      int n= MIN(sizeof(b), (b[1] << 8) | b[2]);
+      if (n > 0) { r= lxi2cReadStream(pC, busAddr, b, n); }
+   }
+   return(r);
+} // ubxDrainJob
+
+// Page select & PWM update as one batch: single ioctl per frame
+static int ledFrameJob (const LXI2CBusCtx *pC, void *pCtx)
+{
+   static LXI2CBatch b; // NB: static for stack economy
+   static U8 phase= 0;
+   const U8 busAddr= (size_t)pCtx;
+   const U8 pg[2]= { 0xFD, 0x00 }; // frame page 0
+   U8 rb[1+16];
+   int r;
+   rb[0]= 0x24; // PWM (first 16 LEDs)
+   for (int i=1; i<sizeof(rb); i++) { rb[i]= (phase + 16 * i) & 0xFF; }
+   lxi2cBatchReset(&b);
+   lxi2cBatchWriteRB(&b, busAddr, pg, sizeof(pg));
+   lxi2cBatchWriteRB(&b, busAddr, rb, sizeof(rb));
+   r= lxi2cBatchExec(pC, &b);
+   phase+= 4;
+   return(r);
+} // ledFrameJob
+
+static int schedDemo (const LXI2CBusCtx *pC, const U8 adsBA)
+{
+   LXI2CSched s;
+   int r;
+   lxi2cSchedInit(&s, pC);
+   lxi2cSchedAdd(&s, "ADS", adsScanJob, (void*)(size_t)adsBA, 0, 2000000, 0);
+   lxi2cSchedAdd(&s, "UBX", ubxDrainJob, (void*)(size_t)0x42, 1000000, 100000000, 20000000);
+   lxi2cSchedAdd(&s, "LED", ledFrameJob, (void*)(size_t)0x74, 500000, NANO_TICKS/60, 0);
+   r= lxi2cSchedRun(&s, 2 * (I64)NANO_TICKS);
+   lxi2cSchedDump(&s, OUT);
+   return(r);
+} // schedDemo
+
+#define ASYNC_ROUNDS (200)
+#define ASYNC_ABSENT (0x33)
+
+// Async engine demo: one client per device. Register reads (ADS conversion, UBX
+// byte count) coalesce across devices, LED frame writes only per device. A read
+// of an absent address every 16 rounds fails its batch, forcing isolation of the
+// other reads. The final round is left pending at stop, to be drained.
+static int asyncDemo (const LXI2CBusCtx *pC, const U8 adsBA)
+{
+   static const U8 led[]= { 0x24, 0x10, 0x20, 0x30, 0x40 }; // PWM register then levels
+   LXI2CAsync a;
+   LXI2CAsyncTrans t[8];
+   RawTimeStamp dl;
+   U32 nSub= 0, nDone= 0, nErr= 0, nRetry= 0;
+
+   if (lxi2cAsyncStart(&a, pC, 3, 16) < 3) { return(-1); }
+   for (int i=0; i<=ASYNC_ROUNDS; i++)
+   {
+      timeSetTarget(&dl, NULL, 500000, TIME_MODE_NOW);
+      nSub+= lxi2cAsyncReadReg(&a, 0, adsBA, 0x00, 2, NULL, &dl);
+      nSub+= lxi2cAsyncReadReg(&a, 1, 0x42, 0xFD, 2, NULL, &dl);
+      nSub+= lxi2cAsyncWriteRB(&a, 2, 0x74, led, sizeof(led), NULL, NULL);
+      if (0 == (i & 0xF)) { nSub+= lxi2cAsyncReadReg(&a, 1, ASYNC_ABSENT, 0x00, 1, NULL, NULL); }
+      if (i < ASYNC_ROUNDS)
+      {
+         usleep(1000);
+         for (int c=0; c<3; c++)
+         {
+            const int n= lxi2cAsyncPoll(&a, c, t, 8);
+            for (int j=0; j<n; j++)
+            {
+               nDone++;
+               if (t[j].r < 0) { nErr++; }
+               if (t[j].flags & LX_I2C_ASYNC_RETRY) { nRetry++; }
+            }
+         }
+      }
+   }
+   lxi2cAsyncStop(&a);
+   report(OUT,"Async: %u submitted, %u polled (%u failed, %u retried), %u drained at stop\n", nSub, nDone, nErr, nRetry, a.nTrans - nDone);
+   report(OUT,"\tengine: %u transactions in %u ioctls (%u retries), %u late, %u lost -> %s\n", a.nTrans, a.nIoctl, a.nRetry, a.nLate, a.nLost,
+      ((a.nTrans == nSub) && (0 == a.nLost)) ? "OK" : "FAIL");
+   return((a.nTrans == nSub) ? (int)a.nTrans : -1);
+} // asyncDemo
+
+static Bool32 openBus (LXI2CArgs *pA)
+{
+   if (pA->flags & ARG_SIM)
+   {
+      if (!lxi2cSimOpen(&gBusCtx, 400, 0, 0)) { return(FALSE); }
+      if (pA->flags & ARG_XPT)
+      {  // BNO08x first: takes precedence should -a give both the same address
+         if (lxi2cSimAddBNO(&gBusCtx, defBA(pA->busAddr, 0x4a)) < 0) { return(FALSE); }
+         lxi2cSimAddADS(&gBusCtx, defBA(pA->busAddr, 0x48), 0);
+      }
+      else if (lxi2cSimAddADS(&gBusCtx, defBA(pA->busAddr, 0x48), 0) < 0) { return(FALSE); }
+      if (pA->flags & (ARG_SCHED|ARG_ASYNC))
+      {
+         lxi2cSimAddUBX(&gBusCtx, 0x42, 0);
+         lxi2cSimAddLED(&gBusCtx, 0x74);
+      }
+      return(TRUE);
+   }
+   return lxi2cOpen(&gBusCtx, pA->devPath, 400);
+} // openBus
+
 int main (int argc, char *argv[])
 {
    int r= -1;
 
    //utilSanityCheck();
+   lxi2cBenchDefault(&(gArgs.bench));
    i2cArgTrans(&gArgs, argc, argv);
 
-   if ((gArgs.flags & ARG_ACTION) && lxi2cOpen(&gBusCtx, gArgs.devPath, 400))
+   if ((gArgs.flags & ARG_ACTION) && openBus(&gArgs))
    {
+      if (gArgs.flags & ARG_CAL)
+      {  // First, so that subsequent actions use path chosen
+         r= lxi2cPathCalibrate(&gBusCtx, defBA(gArgs.busAddr, 0x48), gArgs.bench.reg, (gArgs.flags & ARG_CALWR) ? LX_I2C_CAL_WRITE : 0);
+         lxi2cPathDump(&gBusCtx, OUT);
+         if (lxi2cClockCalibrate(&gBusCtx, defBA(gArgs.busAddr, 0x48), gArgs.bench.reg) > 0)
+         {
+            report(OUT,"I2C clock: nominal %dHz, effective %dHz, overhead %.1fus\n", gBusCtx.clk, gBusCtx.clkEff, 1E-3 * gBusCtx.ovhdNS);
+         }
+      }
       if (gArgs.flags & ARG_HACK) { r= hack(&gBusCtx, defBA(gArgs.busAddr, 0x77)); }
       if (gArgs.flags & ARG_XPT) { r= bnoHack(&gBusCtx, defBA(gArgs.busAddr, 0x4a), 0); }
       if (gArgs.flags & ARG_PING) { r= lxi2cPing(&gBusCtx, defBA(gArgs.busAddr, 0x48), &(gArgs.ping), gArgs.flags); }
       if (gArgs.flags & ARG_DUMP) { r= lxi2cDumpDevAddr(&gBusCtx, gArgs.busAddr, 0xFF,0x00); }
+      if (gArgs.flags & ARG_BENCH) { r= lxi2cBench(stdout, &gBusCtx, defBA(gArgs.busAddr, 0x48), &(gArgs.bench)); }
+      if (gArgs.flags & ARG_SCHED) { r= schedDemo(&gBusCtx, defBA(gArgs.busAddr, 0x48)); }
+      if (gArgs.flags & ARG_ASYNC) { r= asyncDemo(&gBusCtx, defBA(gArgs.busAddr, 0x48)); }
 
       lxi2cClose(&gBusCtx);
    }
@@ -8,6 +8,7 @@
 
 #include "util.h" // necessary ?
 #include <linux/i2c.h>
+#include <pthread.h>
 //#include <linux/i2c-dev.h>
 
 /***/
@@ -35,12 +36,87 @@ typedef struct
    //UL flags; ???
 } PortI2C;
 
-// Bus context
+// Transaction trace: each message of every transfer is captured into a
+// preallocated ring of fixed size records (longer payloads continue in
+// following records). Dumped as binary file: LXI2CTrcHdr then records
+// oldest first (native byte order).
+#define LX_I2C_TRC_NB   (36)  // payload bytes per record
+#define LX_I2C_TRC_VER  (1)
+typedef struct
+{
+   U32   sBgn, nsBgn;   // Transfer begin (RawTimeStamp, seconds truncated)
+   U32   sEnd, nsEnd;   // Transfer end
+   I16   r;             // Transfer result (messages, or -errno)
+   U16   addr, flags;   // As i2c_msg
+   U16   len, off;      // Message length & offset of bytes held in this record
+   U8    iMsg, nMsg;    // Message index & count within transfer
+   U8    b[LX_I2C_TRC_NB];
+} LXI2CTrcRec;
+
+typedef struct
+{
+   char  magic[4];   // "I2CT"
+   U16   ver, recBytes;
+   U32   nRec, clk;
+} LXI2CTrcHdr;
+
+typedef struct
+{
+   LXI2CTrcRec *pR;
+   U32   nRec;    // Capacity (power of 2)
+   U32   iW;      // Records written (total, modulo 2^32)
+} LXI2CTrace;
+
+struct lxi2c_bus_ctx;
+struct lxi2c_prof; // lxI2CProf.h
+
+// Bus backend: transfers with I2C_RDWR semantics (returns messages transferred or
+// <0 with errno set). The kernel i2c-dev interface is the default (NULL) backend.
+typedef struct
+{
+   const char *name;
+   int  (*rdwr) (const struct lxi2c_bus_ctx *pBC, struct i2c_msg m[], const int nM);
+   void (*close) (struct lxi2c_bus_ctx *pBC);
+} LXI2CBackend;
+
+#define LX_I2C_POOL_ALIGN (64) // Cache line
+
+// Message pool: allocated at open (cache line aligned), claimed for exclusive use by
+// multi-block transfers. A claim that finds it busy (another thread) falls back to
+// caller workspace or per-block transfers.
 typedef struct
+{
+   int   busy;
+   int   nMsg;    // Capacity
+   struct i2c_msg m[];
+} LXI2CMsgPool;
+
+#define LX_I2C_CAL_NSZ  (4)  // Payload size classes: 1, 2, 3..8, 9..32 bytes
+#define LX_I2C_CAL_ITER (16) // Transfers measured per path, direction & size class
+
+// Register access path calibration (I2C_RDWR vs SMBus), [0] read, [1] write
+typedef struct
+{
+   U32   nsRDWR[2][LX_I2C_CAL_NSZ], nsSMB[2][LX_I2C_CAL_NSZ]; // Median transfer time (0 -> not measured)
+   U8    smb[2];  // Size classes (bit mask) routed via SMBus
+   I16   slave;   // Address set by I2C_SLAVE (<0 -> none)
+   pthread_mutex_t lock; // Held across I2C_SLAVE & SMBus transfer (slave address is per fd)
+} LXI2CPathCal;
+
+// Bus context
+typedef struct lxi2c_bus_ctx
 {
    UL   flags;
    int  fd;
    int  clk; // bus clock rate used for transaction timing estimation
+   int  clkEff;   // Effective clock rate (Hz) measured by lxi2cClockCalibrate (0 -> clk)
+   int  ovhdNS;   // Fixed per transfer overhead (ns) measured by lxi2cClockCalibrate
+   const LXI2CBackend *pBE;   // NULL -> kernel (i2c-dev)
+   void *pBEC; // backend private context
+   LXI2CTrace *pTrc; // NULL -> no trace
+   struct lxi2c_prof *pPrf; // NULL -> no profile
+   LXI2CMsgPool *pMP; // NULL -> no pool
+   LXI2CPathCal *pPC; // NULL -> I2C_RDWR only
 } LXI2CBusCtx;
 
 // Flags
@@ -59,6 +135,37 @@ typedef struct
 
 extern Bool32 lxi2cOpen (LXI2CBusCtx *pBC, const char devPath[], const int clk);
 
+// Allocate message pool for (at least) nMsg messages (<=0 -> LX_I2C_RDWR_MAX), replacing
+// (and freeing) any pool present - not while transfers are in progress. Returns capacity,
+// <0 on error. pBC->pMP must be valid or NULL.
+extern int lxi2cPoolAlloc (LXI2CBusCtx *pBC, const int nMsg);
+
+// Clock rate (Hz) from argument: <1 -> default 100kHz, <10000 -> kHz else Hz
+extern int lxi2cClockHz (const int clk);
+
+// Effective clock rate (Hz): calibrated if available, else nominal
+extern int lxi2cClockEff (const LXI2CBusCtx *pBC);
+
+// Predicted duration (ns) of transfer spanning nClk bus clocks (including calibrated overhead)
+extern long lxi2cTransNS (const LXI2CBusCtx *pBC, const U32 nClk);
+
+// Time register reads of 1..32 bytes from device and fit (least squares on median per
+// size) duration = overhead + clocks / effective clock, accounting for adapter clock
+// deviation & clock stretching. Both are stored in bus context for all timing
+// predictions. Returns effective clock (Hz), <0 on error.
+extern int lxi2cClockCalibrate (LXI2CBusCtx *pBC, const U8 busAddr, const U8 reg);
+
+// Transfer messages via bus backend: all higher level functions are built on this
+extern int lxi2cRDWR (const LXI2CBusCtx *pBC, struct i2c_msg m[], const int nM);
+
+// Trace: allocate ring of (at least) nRec records, rounded to a power of 2, and attach to bus (replacing any other trace)
+extern int lxi2cTraceStart (LXI2CBusCtx *pBC, LXI2CTrace *pT, const U32 nRec);
+// Detach from bus (records retained for dump)
+extern void lxi2cTraceStop (LXI2CBusCtx *pBC);
+// Write records held (oldest first) to file, returning record count (<0 on error)
+extern int lxi2cTraceDump (const LXI2CTrace *pT, const int clk, const char path[]);
+extern void lxi2cTraceRelease (LXI2CTrace *pT);
+
 // Simple read without write (for stream interface)
 extern int lxi2cReadStream (const LXI2CBusCtx *pBC, const U8 busAddr, U8 b[], const U16 nB);
 // extern int lxi2cWrite (const LXI2CBusCtx *pBC, const U8 busAddr, const U8 b[], const U8 nB);
@@ -71,13 +178,15 @@ extern int lxi2cWriteReg (const LXI2CBusCtx *pBC, const U8 busAddr, U8 regCmd, c
 extern int lxi2cReadRB (const LXI2CBusCtx *pBC, const U8 busAddr, U8 regBytes[], const U8 nRB);
 extern int lxi2cWriteRB (const LXI2CBusCtx *pBC, const U8 busAddr, const U8 regBytes[], const U8 nRB);
 
+// Combined read then write (3 messages, single ioctl) for pipelined device access
+extern int lxi2cReadWriteRB (const LXI2CBusCtx *pBC, const U8 busAddr, U8 rdRB[], const U8 nRdRB, const U8 wrRB[], const U8 nWrRB);
+
 // Multi-message-block transfer extensions for efficiency (?) and convenience
 // when numerous register blocks are to be read or written on a given device.
 // NB - these support uniform block size only and a single device address only
-// within a "batch" of messages. More specific stuff is best achieved by using
-// the "i2c-dev" API directly.
-// CONSIDER: is there a more general abstraction that yields greater elegance
-// without sacrificing efficiency? What about devRegBytes[]={dev,reg,b0..bn} ???
+// within a "batch" of messages. See LXI2CBatch below for the general case.
+// Messages are built in the bus pool (one ioctl per pool capacity, no heap
+// allocation); workspace is optional, used only if the pool is busy.
 extern int lxi2cReadMultiRB
 (
    const LXI2CBusCtx *pBC, // bus info
@@ -97,6 +206,35 @@ extern int lxi2cWriteMultiRB  // ditto
    const U8 nM
 );
 
+// Heterogeneous batch: each entry has its own device address, register, length
+// & direction e.g. ADC result read + IMU header read + LED PWM write. Execution
+// is split transparently into ioctls of at most LX_I2C_RDWR_MAX messages, never
+// separating the messages of a single entry (register write + read).
+#define LX_I2C_RDWR_MAX  (42)   // I2C_RDWR_IOCTL_MAX_MSGS (kernel limit per ioctl)
+#define LX_I2C_BATCH_CAP (128)  // messages per batch
+typedef struct
+{
+   struct i2c_msg m[LX_I2C_BATCH_CAP];
+   U8    first[LX_I2C_BATCH_CAP]; // non-zero at first message of each entry
+   U16   nM, nE;  // message & entry counts
+   U16   nIoctl;  // ioctl calls made by last execution
+   U16   nDone;   // entries completed by last execution (those preceding any failed ioctl)
+} LXI2CBatch;
+
+extern void lxi2cBatchReset (LXI2CBatch *pB);
+
+// Add entry: register read (regBytes[0] register, nRB-1 bytes read into regBytes+1),
+// register-prefixed write, or plain read. Buffers must remain valid until execution.
+// Returns entry index or <0 if batch capacity exceeded.
+extern int lxi2cBatchReadRB (LXI2CBatch *pB, const U8 busAddr, U8 regBytes[], const U8 nRB);
+extern int lxi2cBatchWriteRB (LXI2CBatch *pB, const U8 busAddr, const U8 regBytes[], const U8 nRB);
+extern int lxi2cBatchReadStream (LXI2CBatch *pB, const U8 busAddr, U8 b[], const U16 nB);
+
+// Execute all entries in order, returns messages transferred or <0 on (first) error.
+// A failed ioctl gives no finer detail, so entries from pB->nDone up to the end of
+// that ioctl's chunk have unknown outcome, and later entries were not attempted.
+extern int lxi2cBatchExec (const LXI2CBusCtx *pBC, LXI2CBatch *pB);
+
 // DEPRECATE : first attempt at flexible read/write wrapper - inefficient for write due to (apparently
 // undocumented) single contiguous buffer requirement for writing. (Whereas reading is happily split into
 // write+read portions to match the common mode of device operation.)
@@ -106,6 +244,18 @@ extern Bool32 lxi2cOpenSMBUS (LXI2CBusCtx *pBC, const char *path, I8 devID);
 // f= I2C_SMBUS_READ / I2C_SMBUS_WRITE
 extern int lxi2cTransSMBUS (const LXI2CBusCtx *pBC, const U16 f, U16 nB, U8 *pB, U8 reg);
 
+// Flags
+#define LX_I2C_CAL_WRITE (1<<0) // Calibrate writes also (register content read is written back)
+
+// Measure I2C_RDWR and SMBus (kernel backend with adapter support only) register access
+// to a device for each size class, then route lxi2cReadRB/lxi2cWriteRB (and ReadReg/WriteReg)
+// via SMBus where it is faster by a margin. I2C_RDWR is always used while a trace or
+// profile is attached. Returns count of classes routed via SMBus (<0 on error).
+extern int lxi2cPathCalibrate (LXI2CBusCtx *pBC, const U8 busAddr, const U8 reg, const U8 flags);
+
+// Report calibration measurements & path chosen
+extern void lxi2cPathDump (const LXI2CBusCtx *pBC, const U8 reportID);
+
 extern void lxi2cClose (LXI2CBusCtx *pC);
 
 /***/
@@ -0,0 +1,267 @@
+// Common/MBD/lxI2CAsync.c - asynchronous (queued, coalescing) I2C transaction engine for Linux
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#include "lxI2CAsync.h"
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+
+
+/***/
+
+#define ATOMIC_GET(p)   __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define ATOMIC_SET(p,v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+// Deadline ordering: unset (zero) deadline sorts last
+static Bool32 beforeDL (const RawTimeStamp *pA, const RawTimeStamp *pB)
+{
+   if (0 == pA->tv_sec) { return(FALSE); }
+   if (0 == pB->tv_sec) { return(TRUE); }
+   return timeBefore(pA, pB);
+} // beforeDL
+
+// Any submission pending (engine side)
+static Bool32 pendingSQ (LXI2CAsync *pA)
+{
+   for (int c=0; c<pA->nClient; c++) { if (spscReadPtr(&(pA->c[c].sq))) { return(TRUE); } }
+   return(FALSE);
+} // pendingSQ
+
+// Signal the engine, only if it has declared itself idle (avoids a syscall per
+// submission). Full fences on both sides order the queue update against the
+// idle flag, so either the engine sees the submission or the client sees idle.
+static void wakeEngine (LXI2CAsync *pA)
+{
+   const U64 one= 1;
+   __atomic_thread_fence(__ATOMIC_SEQ_CST);
+   if (ATOMIC_GET(&(pA->idle)) && (write(pA->wakeFD, &one, sizeof(one)) < 0)) { WARN_CALL("() - write failed, errno=%d\n", errno); }
+} // wakeEngine
+
+static int nMsgTrans (const LXI2CAsyncTrans *pT) { return((pT->nW > 0) + (pT->nR > 0)); }
+
+// Write payload (anything beyond a register pointer preceding a read) may have
+// side effects (e.g. start conversion, stream data), so must never be repeated.
+static Bool32 transMutates (const LXI2CAsyncTrans *pT) { return((pT->nW > 1) || ((pT->nW > 0) && (0 == pT->nR))); }
+
+// Take pending transactions from client queues, earliest deadline first, up to the
+// batch & kernel message limits. Client FIFO order is always preserved.
+// Transactions that write are only coalesced with others for the same device,
+// so that a failed batch containing writes is attributable to that device.
+static int gatherBatch (LXI2CAsync *pA, LXI2CAsyncTrans t[], U8 iC[])
+{
+   Bool32 mut= FALSE, mixed= FALSE;
+   int n= 0, nMsg= 0;
+   while (n < LX_I2C_ASYNC_BATCH)
+   {
+      const LXI2CAsyncTrans *pMin= NULL;
+      int cMin= -1, m;
+      for (int c=0; c<pA->nClient; c++)
+      {
+         const LXI2CAsyncTrans *pT= spscReadPtr(&(pA->c[c].sq));
+         if (pT && ((NULL == pMin) || beforeDL(&(pT->deadline), &(pMin->deadline)))) { pMin= pT; cMin= c; }
+      }
+      if (NULL == pMin) { break; }
+      m= nMsgTrans(pMin);
+      if ((nMsg + m) > LX_I2C_RDWR_MAX) { break; }
+      if (n > 0)
+      {
+         const Bool32 other= (pMin->busAddr != t[0].busAddr);
+         if ((pMin->flags | t[0].flags) & LX_I2C_ASYNC_SOLO) { break; }
+         if (transMutates(pMin) ? (mixed || other) : (mut && other)) { break; }
+         mixed|= other;
+      }
+      mut|= transMutates(pMin);
+      t[n]= *pMin;
+      iC[n]= cMin;
+      spscReadRelease(&(pA->c[cMin].sq));
+      n++;
+      nMsg+= m;
+   }
+   return(n);
+} // gatherBatch
+
+// Run n transactions as a single combined transfer
+static int execBatch (const LXI2CBusCtx *pBC, LXI2CAsyncTrans t[], const int n)
+{
+   struct i2c_msg m[LX_I2C_RDWR_MAX];
+   RawTimeStamp tb, te;
+   int nM= 0, r;
+
+   for (int i=0; i<n; i++)
+   {
+      LXI2CAsyncTrans *pT= t+i;
+      if (pT->nW > 0) { m[nM++]= (struct i2c_msg){ .addr= pT->busAddr, .flags= I2C_M_WR, .len= pT->nW, .buf= pT->b }; }
+      if (pT->nR > 0) { m[nM++]= (struct i2c_msg){ .addr= pT->busAddr, .flags= I2C_M_RD, .len= pT->nR, .buf= pT->b + pT->nW }; }
+   }
+   timeStamp(&tb);
+   r= lxi2cRDWR(pBC, m, nM);
+   timeStamp(&te);
+   for (int i=0; i<n; i++)
+   {
+      LXI2CAsyncTrans *pT= t+i;
+      pT->tBgn= tb;
+      pT->tEnd= te;
+      pT->r= (r >= 0) ? nMsgTrans(pT) : r;
+      if ((0 != pT->deadline.tv_sec) && beforeDL(&(pT->deadline), &tb)) { pT->flags|= LX_I2C_ASYNC_LATE; }
+   }
+   return(r);
+} // execBatch
+
+static void *asyncThread (void *p)
+{
+   LXI2CAsync *pA= p;
+   LXI2CAsyncTrans t[LX_I2C_ASYNC_BATCH];
+   U8 iC[LX_I2C_ASYNC_BATCH];
+   int n, run;
+
+   do
+   {
+      run= ATOMIC_GET(&(pA->run)); // NB: must precede gather (drain on stop)
+      n= gatherBatch(pA, t, iC);
+      if (n > 0)
+      {
+         pA->nIoctl++;
+         if ((execBatch(pA->pBC, t, n) < 0) && (n > 1))
+         {  // Isolate failure: one device NAK must not fail others. Messages preceding
+            // the failure have already been sent, so writes complete with the error.
+            for (int i=0; i<n; i++)
+            {
+               if (!transMutates(t+i))
+               {
+                  t[i].flags|= LX_I2C_ASYNC_RETRY;
+                  execBatch(pA->pBC, t+i, 1);
+                  pA->nIoctl++;
+                  pA->nRetry++;
+               }
+            }
+         }
+         for (int i=0; i<n; i++)
+         {
+            pA->nLate+= (0 != (t[i].flags & LX_I2C_ASYNC_LATE));
+            if (!spscPush(&(pA->c[iC[i]].cq), t+i)) { pA->nLost++; } // client not polling
+         }
+         pA->nTrans+= n;
+      }
+      else if (run)
+      {  // Declare idle then re-check before blocking: eventfd count persists, so no wake is lost
+         U64 v;
+         ATOMIC_SET(&(pA->idle), 1);
+         __atomic_thread_fence(__ATOMIC_SEQ_CST);
+         if (!pendingSQ(pA) && ATOMIC_GET(&(pA->run)) && (read(pA->wakeFD, &v, sizeof(v)) < 0) && (EINTR != errno))
+         {
+            WARN_CALL("() - read failed, errno=%d\n", errno);
+         }
+         ATOMIC_SET(&(pA->idle), 0);
+      }
+   } while (run || (n > 0));
+   return(NULL);
+} // asyncThread
+
+
+/***/
+
+int lxi2cAsyncStart (LXI2CAsync *pA, const LXI2CBusCtx *pBC, const int nClient, const int depth)
+{
+   int r, c;
+
+   memset(pA, 0, sizeof(*pA));
+   if ((nClient <= 0) || (nClient > LX_I2C_ASYNC_CLIENT_MAX) || (depth <= 0)) { return(-1); }
+   for (c=0; c<nClient; c++)
+   {
+      if (!spscInit(&(pA->c[c].sq), depth, sizeof(LXI2CAsyncTrans))) { break; }
+      if (!spscInit(&(pA->c[c].cq), depth, sizeof(LXI2CAsyncTrans))) { spscRelease(&(pA->c[c].sq)); break; }
+   }
+   pA->nClient= c;
+   pA->pBC= pBC;
+   pA->run= 1;
+   pA->wakeFD= eventfd(0, EFD_CLOEXEC);
+   r= ((c == nClient) && (pA->wakeFD >= 0)) ? pthread_create(&(pA->th), NULL, asyncThread, pA) : -1;
+   if (0 != r)
+   {
+      ERROR_CALL("(.. %d, %d) - %d\n", nClient, depth, r);
+      pA->run= 0;
+      if (pA->wakeFD >= 0) { close(pA->wakeFD); }
+      for (c=0; c<pA->nClient; c++) { spscRelease(&(pA->c[c].sq)); spscRelease(&(pA->c[c].cq)); }
+      pA->nClient= 0;
+      return(-1);
+   }
+   return(pA->nClient);
+} // lxi2cAsyncStart
+
+void lxi2cAsyncStop (LXI2CAsync *pA)
+{
+   if (pA->nClient > 0)
+   {
+      const U64 one= 1;
+      ATOMIC_SET(&(pA->run), 0);
+      if (write(pA->wakeFD, &one, sizeof(one)) < 0) { WARN_CALL("() - write failed, errno=%d\n", errno); }
+      pthread_join(pA->th, NULL);
+      close(pA->wakeFD);
+      for (int c=0; c<pA->nClient; c++) { spscRelease(&(pA->c[c].sq)); spscRelease(&(pA->c[c].cq)); }
+      pA->nClient= 0;
+   }
+} // lxi2cAsyncStop
+
+LXI2CAsyncTrans *lxi2cAsyncSlot (LXI2CAsync *pA, const int iC) { return spscWritePtr(&(pA->c[iC].sq)); }
+
+void lxi2cAsyncCommit (LXI2CAsync *pA, const int iC)
+{
+   spscWriteCommit(&(pA->c[iC].sq));
+   wakeEngine(pA);
+} // lxi2cAsyncCommit
+
+int lxi2cAsyncSubmit (LXI2CAsync *pA, const int iC, const LXI2CAsyncTrans *pT)
+{
+   int r;
+   if ((0 == (pT->nW + pT->nR)) || ((pT->nW + pT->nR) > LX_I2C_ASYNC_NB)) { return(-1); } // nothing to send, or too much
+   r= spscPush(&(pA->c[iC].sq), pT);
+   if (r) { wakeEngine(pA); }
+   return(r);
+} // lxi2cAsyncSubmit
+
+static LXI2CAsyncTrans *initSlot (LXI2CAsync *pA, const int iC, const U8 busAddr, void *pUser, const RawTimeStamp *pDeadline)
+{
+   LXI2CAsyncTrans *pT= lxi2cAsyncSlot(pA, iC);
+   if (pT)
+   {
+      if (pDeadline) { pT->deadline= *pDeadline; } else { pT->deadline.tv_sec= pT->deadline.tv_nsec= 0; }
+      pT->pUser= pUser;
+      pT->r= 0;
+      pT->busAddr= busAddr;
+      pT->flags= 0;
+   }
+   return(pT);
+} // initSlot
+
+int lxi2cAsyncReadReg (LXI2CAsync *pA, const int iC, const U8 busAddr, const U8 reg, const U8 nR, void *pUser, const RawTimeStamp *pDeadline)
+{
+   LXI2CAsyncTrans *pT;
+   if ((nR + 1) > LX_I2C_ASYNC_NB) { return(-1); }
+   pT= initSlot(pA, iC, busAddr, pUser, pDeadline);
+   if (NULL == pT) { return(0); }
+   pT->b[0]= reg;
+   pT->nW= 1;
+   pT->nR= nR;
+   lxi2cAsyncCommit(pA, iC);
+   return(1);
+} // lxi2cAsyncReadReg
+
+int lxi2cAsyncWriteRB (LXI2CAsync *pA, const int iC, const U8 busAddr, const U8 regBytes[], const U8 nRB, void *pUser, const RawTimeStamp *pDeadline)
+{
+   LXI2CAsyncTrans *pT;
+   if ((0 == nRB) || (nRB > LX_I2C_ASYNC_NB)) { return(-1); }
+   pT= initSlot(pA, iC, busAddr, pUser, pDeadline);
+   if (NULL == pT) { return(0); }
+   memcpy(pT->b, regBytes, nRB);
+   pT->nW= nRB;
+   pT->nR= 0;
+   lxi2cAsyncCommit(pA, iC);
+   return(1);
+} // lxi2cAsyncWriteRB
+
+int lxi2cAsyncPoll (LXI2CAsync *pA, const int iC, LXI2CAsyncTrans t[], const int max)
+{
+   return spscPop(&(pA->c[iC].cq), t, max);
+} // lxi2cAsyncPoll
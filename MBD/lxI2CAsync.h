@@ -0,0 +1,90 @@
+// Common/MBD/lxI2CAsync.h - asynchronous (queued, coalescing) I2C transaction engine for Linux
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#ifndef LX_I2C_ASYNC_H
+#define LX_I2C_ASYNC_H
+
+#include <pthread.h>
+#include "lxI2C.h"
+#include "lxTiming.h"
+#include "spscRing.h"
+
+
+/***/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LX_I2C_ASYNC_NB          (32)  // Max bytes per transaction (write + read)
+#define LX_I2C_ASYNC_CLIENT_MAX  (4)
+#define LX_I2C_ASYNC_BATCH       (16)  // Max transactions coalesced into one ioctl
+
+// Transaction flags
+#define LX_I2C_ASYNC_LATE  (1<<0)   // Completion: started after deadline
+#define LX_I2C_ASYNC_SOLO  (1<<1)   // Submission: never coalesce (e.g. device intolerant of repeated START)
+#define LX_I2C_ASYNC_RETRY (1<<2)   // Completion: re-run individually after coalesced failure (read only:
+                                    // register pointer + read, writes are never repeated)
+
+// Transaction descriptor: submitted by client, returned (with results) on completion.
+// Write part (typically register prefix + payload) is sent first, then read part
+// fetched, as a single combined transaction (repeated START).
+typedef struct
+{
+   RawTimeStamp deadline;     // Latest intended start (tv_sec == 0 -> none): earliest served first
+   RawTimeStamp tBgn, tEnd;   // Completion: ioctl time bracket (shared by coalesced transactions)
+   void  *pUser;              // Client tag, returned unchanged
+   int   r;                   // Completion: ioctl result (<0 error)
+   U8    busAddr;
+   U8    nW, nR;              // Byte counts: write from b[0], then read into b[nW]
+   U8    flags;
+   U8    b[LX_I2C_ASYNC_NB];
+} LXI2CAsyncTrans;
+
+// Each client (e.g. sensor driver on its own thread) owns a submission and
+// completion queue pair, keeping all queues single producer single consumer.
+typedef struct
+{
+   SPSCRing sq, cq;
+} LXI2CAsyncClient;
+
+typedef struct
+{
+   LXI2CAsyncClient  c[LX_I2C_ASYNC_CLIENT_MAX];
+   const LXI2CBusCtx *pBC;
+   pthread_t th;
+   int   run, nClient;
+   int   idle, wakeFD;   // Engine blocked (on eventfd) when all queues empty, clients wake it
+   U32   nTrans, nIoctl, nLate, nRetry, nLost; // Statistics (engine thread)
+} LXI2CAsync;
+
+
+/***/
+
+// Start engine thread for bus, with nClient queue pairs of (at least) depth records
+extern int lxi2cAsyncStart (LXI2CAsync *pA, const LXI2CBusCtx *pBC, const int nClient, const int depth);
+
+// Stop engine thread (pending submissions are completed first) and release queues
+extern void lxi2cAsyncStop (LXI2CAsync *pA);
+
+// Client: zero-copy submission slot (NULL if queue full) then commit, or copying submit
+// (rejects empty or oversize transactions, <0). Either wakes an idle engine.
+extern LXI2CAsyncTrans *lxi2cAsyncSlot (LXI2CAsync *pA, const int iC);
+extern void lxi2cAsyncCommit (LXI2CAsync *pA, const int iC);
+extern int lxi2cAsyncSubmit (LXI2CAsync *pA, const int iC, const LXI2CAsyncTrans *pT);
+
+// Client convenience: register read (nR bytes following register byte) or register-prefixed write.
+// Deadline (optional) is absolute. Returns 1 if queued, 0 if queue full, <0 on error.
+extern int lxi2cAsyncReadReg (LXI2CAsync *pA, const int iC, const U8 busAddr, const U8 reg, const U8 nR, void *pUser, const RawTimeStamp *pDeadline);
+extern int lxi2cAsyncWriteRB (LXI2CAsync *pA, const int iC, const U8 busAddr, const U8 regBytes[], const U8 nRB, void *pUser, const RawTimeStamp *pDeadline);
+
+// Client: collect up to max completed transactions (non-blocking)
+extern int lxi2cAsyncPoll (LXI2CAsync *pA, const int iC, LXI2CAsyncTrans t[], const int max);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // LX_I2C_ASYNC_H
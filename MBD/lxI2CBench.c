@@ -0,0 +1,190 @@
+// Common/MBD/lxI2CBench.c - I2C bus throughput & latency benchmark
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#include <sys/utsname.h>
+#include "lxI2CBench.h"
+#include "lxTiming.h"
+
+
+/***/
+
+static const char *gShapeName[]={ "write", "read", "wrrd", "multi" };
+
+static int shapeIdx (const U8 shape)
+{
+   int i= 0;
+   while ((i < 3) && (0 == (shape & (1<<i)))) { i++; }
+   return(i);
+} // shapeIdx
+
+// Ideal bus clocks for one transaction (address & ACK bits, no STOP/START gaps)
+static U32 shapeNClk (const U8 shape, const U8 nB, const U8 nBatch)
+{
+   switch(shape)
+   {
+      case LX_I2C_BENCH_WR : return I2C_ADDR_BITS_NCLK(8, 8 * (1 + nB));
+      case LX_I2C_BENCH_RD : return I2C_ADDR_BITS_NCLK(8, 8 * nB);
+      case LX_I2C_BENCH_WRRD : return I2C_ADDR_BITS_NCLK(8, 8) + I2C_ADDR_BITS_NCLK(8, 8 * nB);
+      case LX_I2C_BENCH_MULTI : return nBatch * (I2C_ADDR_BITS_NCLK(8, 8) + I2C_ADDR_BITS_NCLK(8, 8 * nB));
+   }
+   return(0);
+} // shapeNClk
+
+static int cmpU64 (const void *pA, const void *pB)
+{
+   const U64 a= *(const U64*)pA, b= *(const U64*)pB;
+   return((a > b) - (a < b));
+} // cmpU64
+
+// Percentiles 50, 90, 99 & max of sorted samples
+static void percentiles (U64 pNS[4], U64 t[], const U32 n)
+{
+   if (n <= 0) { memset(pNS, 0, 4*sizeof(pNS[0])); return; }
+   qsort(t, n, sizeof(t[0]), cmpU64);
+   pNS[0]= t[(n * 50) / 100];
+   pNS[1]= t[(n * 90) / 100];
+   pNS[2]= t[(n * 99) / 100];
+   pNS[3]= t[n-1];
+} // percentiles
+
+static int benchTrans (const LXI2CBusCtx *pC, const U8 busAddr, U8 b[], const U8 shape, const U8 nB, const U8 nBatch)
+{
+   switch(shape)
+   {
+      case LX_I2C_BENCH_WR : return lxi2cWriteRB(pC, busAddr, b, 1+nB);
+      case LX_I2C_BENCH_RD : return lxi2cReadStream(pC, busAddr, b+1, nB);
+      case LX_I2C_BENCH_WRRD : return lxi2cReadRB(pC, busAddr, b, 1+nB);
+      case LX_I2C_BENCH_MULTI : return lxi2cReadMultiRB(pC, NULL, busAddr, b, 1+nB, nBatch);
+   }
+   return(-1);
+} // benchTrans
+
+
+/***/
+
+void lxi2cBenchDefault (LXI2CBenchParam *pP)
+{
+   static const U8 nB[]={1,2,4,8,16,32};
+   memset(pP, 0, sizeof(*pP));
+   pP->nNB= sizeof(nB);
+   memcpy(pP->nB, nB, pP->nNB);
+   pP->shapes=    LX_I2C_BENCH_ALL;
+   pP->maxBatch=  8;
+   pP->fmt=       LX_I2C_BENCH_CSV;
+   pP->nIter=     1000;
+} // lxi2cBenchDefault
+
+int lxi2cBenchPoint (LXI2CBenchRes *pR, const LXI2CBusCtx *pC, const U8 busAddr, const LXI2CBenchParam *pP, const U8 shape, const U8 nB, const U8 nBatch)
+{
+   const int k= (LX_I2C_BENCH_MULTI == shape) ? nBatch : 1;
+   U8 *pB;
+   U64 *pT;
+   U32 nT= 0;
+   RawTimeStamp t0, t1, tB, tE, tT;
+   int r;
+
+   memset(pR, 0, sizeof(*pR));
+   pR->shape= shape; pR->nB= nB; pR->nBatch= k;
+   pR->idealNS= ((U64)shapeNClk(shape, nB, k) * NANO_TICKS) / lxi2cClockEff(pC);
+   if ((nB <= 0) || (k <= 0) || (k > LX_I2C_BENCH_BATCH_MAX) || (pP->nIter <= 0)) { return(-1); }
+
+   pB= malloc(k * (1+nB));
+   pT= malloc(pP->nIter * sizeof(*pT));
+   if ((NULL == pB) || (NULL == pT)) { r= -1; goto lExit; }
+   for (int j=0; j<k; j++) { pB[j * (1+nB)]= pP->reg; }
+   if (LX_I2C_BENCH_WR == shape)
+   {  // Write back current content so the device state is unchanged
+      r= lxi2cReadRB(pC, busAddr, pB, 1+nB);
+      if (r < 0) { pR->nErr= pP->nIter; goto lExit; }
+   }
+   timeSetTarget(&tT, &t0, 0, TIME_MODE_NOW);
+   for (U32 i=0; i<pP->nIter; i++)
+   {
+      if (pP->ivlNS > 0) { timeSpinWaitUntil(&tB, &tT); timeSetTarget(&tT, NULL, pP->ivlNS, TIME_MODE_RELATIVE); }
+      timeStamp(&tB);
+      r= benchTrans(pC, busAddr, pB, shape, nB, k);
+      timeStamp(&tE);
+      if (r < 0) { pR->nErr++; } else { pT[nT++]= MAX(0, timeDiffNS(&tB, &tE)); }
+   }
+   timeStamp(&t1);
+   pR->nIter= pP->nIter;
+   percentiles(pR->pNS, pT, nT);
+   {
+      const I64 dNS= timeDiffNS(&t0, &t1);
+      if (dNS > 0) { pR->bytesPerSec= ((F64)nT * k * nB * NANO_TICKS) / dNS; }
+   }
+   r= nT;
+lExit:
+   if (pT) { free(pT); }
+   if (pB) { free(pB); }
+   return(r);
+} // lxi2cBenchPoint
+
+static void benchHeader (FILE *hOut, const LXI2CBusCtx *pC, const U8 busAddr, const U8 fmt)
+{
+   struct utsname u;
+   const char *kr= (0 == uname(&u)) ? u.release : "?";
+   if (LX_I2C_BENCH_JSON == fmt)
+   {
+      fprintf(hOut, "{\"kernel\":\"%s\",\"clk\":%d,\"clk_eff\":%d,\"addr\":%d,\"results\":[", kr, pC->clk, lxi2cClockEff(pC), busAddr);
+   }
+   else
+   {
+      fprintf(hOut, "# kernel=%s, clk=%d, clk_eff=%d, addr=0x%02X\n", kr, pC->clk, lxi2cClockEff(pC), busAddr);
+      fprintf(hOut, "shape,bytes,batch,iter,err,ideal_ns,p50_ns,p90_ns,p99_ns,max_ns,bytes_per_s,efficiency\n");
+   }
+} // benchHeader
+
+static void benchResult (FILE *hOut, const LXI2CBenchRes *pR, const U8 fmt, const int i)
+{
+   const F32 eff= (pR->pNS[0] > 0) ? (F32)pR->idealNS / pR->pNS[0] : 0; // ideal / median
+   const unsigned long long iNS= pR->idealNS, p50= pR->pNS[0], p90= pR->pNS[1], p99= pR->pNS[2], pMax= pR->pNS[3];
+   if (LX_I2C_BENCH_JSON == fmt)
+   {
+      fprintf(hOut, "%s\n{\"shape\":\"%s\",\"bytes\":%u,\"batch\":%u,\"iter\":%u,\"err\":%u,\"ideal_ns\":%llu,"
+         "\"p50_ns\":%llu,\"p90_ns\":%llu,\"p99_ns\":%llu,\"max_ns\":%llu,\"bytes_per_s\":%.1f,\"efficiency\":%.4f}",
+         (i > 0) ? "," : "", gShapeName[shapeIdx(pR->shape)], pR->nB, pR->nBatch, pR->nIter, pR->nErr, iNS,
+         p50, p90, p99, pMax, pR->bytesPerSec, eff);
+   }
+   else
+   {
+      fprintf(hOut, "%s,%u,%u,%u,%u,%llu,%llu,%llu,%llu,%llu,%.1f,%.4f\n",
+         gShapeName[shapeIdx(pR->shape)], pR->nB, pR->nBatch, pR->nIter, pR->nErr, iNS,
+         p50, p90, p99, pMax, pR->bytesPerSec, eff);
+   }
+} // benchResult
+
+int lxi2cBench (FILE *hOut, const LXI2CBusCtx *pC, const U8 busAddr, const LXI2CBenchParam *pP)
+{
+   LXI2CBenchRes res;
+   int n= 0, nFail= 0;
+
+   if ((NULL == hOut) || (lxi2cClockEff(pC) <= 0)) { return(-1); }
+   benchHeader(hOut, pC, busAddr, pP->fmt);
+   for (int s=0; s<4; s++)
+   {
+      const U8 shape= 1<<s;
+      if (pP->shapes & shape)
+      {
+         const int nK= (LX_I2C_BENCH_MULTI == shape) ? MIN(pP->maxBatch, LX_I2C_BENCH_BATCH_MAX) : 1;
+         for (int i=0; i<pP->nNB; i++)
+         {
+            for (int k=1; k<=nK; k++)
+            {
+               if (lxi2cBenchPoint(&res, pC, busAddr, pP, shape, pP->nB[i], k) < 0)
+               {
+                  WARN_CALL("() - %s %uB x%d failed (%u errors)\n", gShapeName[shapeIdx(shape)], pP->nB[i], k, res.nErr);
+                  nFail++;
+               }
+               else { benchResult(hOut, &res, pP->fmt, n++); }
+            }
+         }
+      }
+   }
+   if (LX_I2C_BENCH_JSON == pP->fmt) { fprintf(hOut, "\n]}\n"); }
+   fflush(hOut);
+   if ((0 == n) && (nFail > 0)) { return(-1); }
+   return(n);
+} // lxi2cBench
@@ -0,0 +1,72 @@
+// Common/MBD/lxI2CBench.h - I2C bus throughput & latency benchmark
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#ifndef LX_I2C_BENCH_H
+#define LX_I2C_BENCH_H
+
+#include <stdio.h>
+#include "lxI2C.h"
+
+
+/***/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Transaction shapes
+#define LX_I2C_BENCH_WR    (1<<0)   // Register prefixed write (value previously read back: idempotent)
+#define LX_I2C_BENCH_RD    (1<<1)   // Plain read (no register prefix)
+#define LX_I2C_BENCH_WRRD  (1<<2)   // Register write then read (repeated START)
+#define LX_I2C_BENCH_MULTI (1<<3)   // lxi2cReadMultiRB batches of 1..maxBatch
+#define LX_I2C_BENCH_ALL   (0xF)
+
+// Output formats
+#define LX_I2C_BENCH_CSV   (0)
+#define LX_I2C_BENCH_JSON  (1)
+
+#define LX_I2C_BENCH_NB_MAX    (8)  // Payload sizes per sweep
+#define LX_I2C_BENCH_BATCH_MAX (LX_I2C_RDWR_MAX/2)
+
+typedef struct
+{
+   U8    nB[LX_I2C_BENCH_NB_MAX], nNB; // Payload sizes (bytes, excluding register)
+   U8    reg;        // Register used by register prefixed shapes
+   U8    shapes;     // LX_I2C_BENCH_* mask
+   U8    maxBatch;
+   U8    fmt;        // LX_I2C_BENCH_CSV / JSON
+   U32   nIter;      // Transactions per measurement point
+   long  ivlNS;      // Pacing between transactions (0 -> back to back)
+} LXI2CBenchParam;
+
+// Measurement point
+typedef struct
+{
+   U8    shape, nB, nBatch;
+   U32   nIter, nErr;
+   U64   idealNS;    // I2C_ADDR_BITS_NCLK at effective bus clock
+   U64   pNS[4];     // Latency percentiles: 50, 90, 99, 100 (max)
+   F32   bytesPerSec;   // Payload achieved (wall time, including any pacing)
+} LXI2CBenchRes;
+
+
+/***/
+
+// Default sweep: 1,2,4,8,16,32 bytes, all shapes, batches up to 8, 1000 iterations, CSV
+extern void lxi2cBenchDefault (LXI2CBenchParam *pP);
+
+// Measure one point
+extern int lxi2cBenchPoint (LXI2CBenchRes *pR, const LXI2CBusCtx *pC, const U8 busAddr, const LXI2CBenchParam *pP, const U8 shape, const U8 nB, const U8 nBatch);
+
+// Run sweep, writing results (with host kernel & bus clock) to hOut. Points that
+// fail (e.g. device absent) are reported and omitted. Returns number of points
+// measured (<0 on error or if none succeed).
+extern int lxi2cBench (FILE *hOut, const LXI2CBusCtx *pC, const U8 busAddr, const LXI2CBenchParam *pP);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // LX_I2C_BENCH_H
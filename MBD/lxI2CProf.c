@@ -0,0 +1,160 @@
+// Common/MBD/lxI2CProf.c - I2C bus occupancy & latency profiler
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#include "lxI2CProf.h"
+
+
+/***/
+
+#define PRF_ADD(x,v) __atomic_fetch_add(&(x), (v), __ATOMIC_RELAXED)
+
+// Bucket i covers [2^(i-1), 2^i) microseconds
+static int hBucket (const I64 ns)
+{
+   U64 us= (ns > 0) ? ns / 1000 : 0;
+   int i= 0;
+   while ((us > 0) && (i < (LX_I2C_PRF_NHB-1))) { us>>= 1; i++; }
+   return(i);
+} // hBucket
+
+static void statAdd (LXI2CProfStat *pS, const int nM, const int nW, const int nR, const int err, const int retry, const I64 dNS, const I64 iNS)
+{
+   PRF_ADD(pS->nTrans, 1);
+   PRF_ADD(pS->nMsg, nM);
+   if (err) { PRF_ADD(pS->nErr, 1); }
+   if (retry) { PRF_ADD(pS->nRetry, 1); }
+   PRF_ADD(pS->nByteW, nW);
+   PRF_ADD(pS->nByteR, nR);
+   PRF_ADD(pS->sumNS, dNS);
+   PRF_ADD(pS->sumIdealNS, iNS);
+   PRF_ADD(pS->hDur[hBucket(dNS)], 1);
+   PRF_ADD(pS->hOvhd[hBucket(dNS - iNS)], 1);
+} // statAdd
+
+static I64 idealNS (const U16 len, const int clk) { return((I2C_BYTES_NCLK((U32)len) * (I64)NANO_TICKS) / clk); }
+
+
+/***/
+
+void lxi2cProfStart (LXI2CBusCtx *pBC, LXI2CProfile *pP)
+{
+   memset(pP, 0, sizeof(*pP));
+   pP->clk= lxi2cClockEff(pBC);
+   timeStamp(&(pP->t0));
+   pP->tDump= pP->t0;
+   pBC->pPrf= pP;
+} // lxi2cProfStart
+
+void lxi2cProfStop (LXI2CBusCtx *pBC) { pBC->pPrf= NULL; }
+
+void lxi2cProfRec (LXI2CProfile *pP, const struct i2c_msg m[], const int nM, const int r, const RawTimeStamp *pB, const RawTimeStamp *pE)
+{
+   const I64 dNS= timeDiffNS(pB, pE);
+   const int err= (r < 0);
+   I64 iNS= 0;
+   int nW= 0, nR= 0, retry= 0;
+   U8 done[LX_I2C_PRF_NDEV>>3];
+
+   for (int i=0; i<nM; i++)
+   {
+      iNS+= idealNS(m[i].len, pP->clk);
+      if (m[i].flags & I2C_M_RD) { nR+= m[i].len; } else { nW+= m[i].len; }
+   }
+   // Per device: each distinct address in transfer
+   memset(done, 0, sizeof(done));
+   for (int i=0; i<nM; i++)
+   {
+      const U8 a= m[i].addr & (LX_I2C_PRF_NDEV-1);
+      if (0 == (done[a>>3] & (1 << (a & 0x7))))
+      {
+         I64 iDev= 0;
+         int nMD= 0, nWD= 0, nRD= 0;
+         done[a>>3]|= 1 << (a & 0x7);
+         for (int j=i; j<nM; j++)
+         {
+            if ((m[j].addr & (LX_I2C_PRF_NDEV-1)) == a)
+            {
+               nMD++;
+               iDev+= idealNS(m[j].len, pP->clk);
+               if (m[j].flags & I2C_M_RD) { nRD+= m[j].len; } else { nWD+= m[j].len; }
+            }
+         }
+         retry|= pP->errLast[a];
+         statAdd(pP->dev+a, nMD, nWD, nRD, err, pP->errLast[a], (iNS > 0) ? (dNS * iDev) / iNS : dNS, iDev);
+         pP->errLast[a]= err;
+      }
+   }
+   statAdd(&(pP->bus), nM, nW, nR, err, retry, dNS, iNS);
+} // lxi2cProfRec
+
+F32 lxi2cProfSnapshot (LXI2CProfile *pS, const LXI2CProfile *pP)
+{
+   RawTimeStamp t;
+   memcpy(pS, pP, sizeof(*pS));
+   timeStamp(&t);
+   return timeDiff(&(pP->t0), &t);
+} // lxi2cProfSnapshot
+
+F32 lxi2cProfOccupancy (F32 *pIdeal, const LXI2CProfStat *pS, const F32 sec)
+{
+   if (sec <= 0) { if (pIdeal) { *pIdeal= 0; } return(0); }
+   if (pIdeal) { *pIdeal= 1E-9 * pS->sumIdealNS / sec; }
+   return(1E-9 * pS->sumNS / sec);
+} // lxi2cProfOccupancy
+
+static void dumpHist (const char *name, const U32 h[], const U8 reportID)
+{
+   report(reportID, "\t%s (us):", name);
+   for (int i=0; i<LX_I2C_PRF_NHB; i++)
+   {
+      if (h[i] > 0)
+      {
+         if (i < (LX_I2C_PRF_NHB-1)) { report(reportID, " <%d:%u", 1<<i, h[i]); }
+         else { report(reportID, " >=%d:%u", 1<<(i-1), h[i]); }
+      }
+   }
+   report(reportID, "%s", "\n");
+} // dumpHist
+
+static F32 meanUS (const U64 sumNS, const U32 n) { return((n > 0) ? 1E-3 * sumNS / n : 0); }
+
+void lxi2cProfDump (const LXI2CProfile *pP, const U8 reportID)
+{
+   LXI2CProfile s;
+   const LXI2CProfStat *pB= &(s.bus);
+   const F32 sec= lxi2cProfSnapshot(&s, pP);
+   F32 oi, o= lxi2cProfOccupancy(&oi, pB, sec);
+
+   report(reportID, "I2C profile: %.3fs @ %dHz, %u transfers (%u msg), %u errors, %u retries, %llu/%llu bytes W/R\n",
+      sec, s.clk, pB->nTrans, pB->nMsg, pB->nErr, pB->nRetry, (unsigned long long)pB->nByteW, (unsigned long long)pB->nByteR);
+   report(reportID, "\toccupancy %.2f%% (ideal %.2f%%), mean %.1fus (ideal %.1fus)\n",
+      100 * o, 100 * oi, meanUS(pB->sumNS, pB->nTrans), meanUS(pB->sumIdealNS, pB->nTrans));
+   dumpHist("duration", pB->hDur, reportID);
+   dumpHist("overhead", pB->hOvhd, reportID);
+   for (int a=0; a<LX_I2C_PRF_NDEV; a++)
+   {
+      const LXI2CProfStat *pD= s.dev+a;
+      if (pD->nTrans > 0)
+      {
+         o= lxi2cProfOccupancy(&oi, pD, sec);
+         report(reportID, "\t0x%02X: %u transfers, %u errors, %u retries, %llu/%llu bytes, occupancy %.2f%% (ideal %.2f%%), mean %.1fus\n",
+            a, pD->nTrans, pD->nErr, pD->nRetry, (unsigned long long)pD->nByteW, (unsigned long long)pD->nByteR,
+            100 * o, 100 * oi, meanUS(pD->sumNS, pD->nTrans));
+      }
+   }
+} // lxi2cProfDump
+
+int lxi2cProfPoll (LXI2CProfile *pP, const long ivlNS, const U8 reportID)
+{
+   RawTimeStamp t;
+   timeStamp(&t);
+   if (timeDiffNS(&(pP->tDump), &t) >= ivlNS)
+   {
+      pP->tDump= t;
+      lxi2cProfDump(pP, reportID);
+      return(1);
+   }
+   return(0);
+} // lxi2cProfPoll
@@ -0,0 +1,71 @@
+// Common/MBD/lxI2CProf.h - I2C bus occupancy & latency profiler
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#ifndef LX_I2C_PROF_H
+#define LX_I2C_PROF_H
+
+#include "lxI2C.h"
+#include "lxTiming.h"
+
+
+/***/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LX_I2C_PRF_NHB  (16)  // Histogram buckets: [0] < 1us, [i] < 2^i us, [15] >= 16ms
+#define LX_I2C_PRF_NDEV (128) // 7bit bus addresses
+
+// Counters (per bus & per device). Transfers involving several devices count
+// once for each, with duration shared in proportion to ideal bus time.
+typedef struct
+{
+   U32   nTrans, nMsg;
+   U32   nErr;    // Failed transfers
+   U32   nRetry;  // Transfers to a device immediately following its failure
+   U64   nByteW, nByteR;
+   U64   sumNS, sumIdealNS; // Measured (ioctl) & ideal (I2C_BYTES_NCLK at effective clk) durations
+   U32   hDur[LX_I2C_PRF_NHB];   // Measured duration
+   U32   hOvhd[LX_I2C_PRF_NHB];  // Measured less ideal (software & driver overhead)
+} LXI2CProfStat;
+
+typedef struct lxi2c_prof
+{
+   LXI2CProfStat bus, dev[LX_I2C_PRF_NDEV];
+   RawTimeStamp t0, tDump; // Start & last periodic dump
+   int   clk;    // Effective (calibrated where available) bus clock at start
+   U8    errLast[LX_I2C_PRF_NDEV]; // Last transfer to device failed
+} LXI2CProfile;
+
+
+/***/
+
+// Clear and attach profile to bus (replacing any other)
+extern void lxi2cProfStart (LXI2CBusCtx *pBC, LXI2CProfile *pP);
+extern void lxi2cProfStop (LXI2CBusCtx *pBC);
+
+// Record completed transfer (called by lxi2cRDWR, r as returned by backend)
+extern void lxi2cProfRec (LXI2CProfile *pP, const struct i2c_msg m[], const int nM, const int r, const RawTimeStamp *pB, const RawTimeStamp *pE);
+
+// Copy counters (approximate while bus active: no lock is taken) returning
+// elapsed seconds since start
+extern F32 lxi2cProfSnapshot (LXI2CProfile *pS, const LXI2CProfile *pP);
+
+// Occupancy (fraction of wall time) measured & ideal for stat over elapsed seconds
+extern F32 lxi2cProfOccupancy (F32 *pIdeal, const LXI2CProfStat *pS, const F32 sec);
+
+// Report bus summary, active devices & histograms
+extern void lxi2cProfDump (const LXI2CProfile *pP, const U8 reportID);
+
+// Dump when at least ivlNS elapsed since last dump (for periodic call from
+// application loop), returning 1 if dumped
+extern int lxi2cProfPoll (LXI2CProfile *pP, const long ivlNS, const U8 reportID);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // LX_I2C_PROF_H
@@ -0,0 +1,173 @@
+// Common/MBD/lxI2CReplay.c - I2C bus backend replaying a captured transaction trace
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#include <errno.h>
+#include "lxI2CReplay.h"
+#include "lxTiming.h"
+
+
+/***/
+
+typedef struct
+{
+   LXI2CTrcRec *pR;
+   U32   nRec, iNext;   // Records & next unconsumed transfer start
+   RawTimeStamp tCap0, tRep0; // Timing origins: capture (first replayed begin) & replay (zero -> unset)
+   LXI2CReplayStat stat;
+   U8    flags;
+} Replay;
+
+static Bool32 transStart (const LXI2CTrcRec *pR) { return((0 == pR->iMsg) && (0 == pR->off)); }
+
+// Index following the transfer starting at i
+static U32 transNext (const Replay *pP, U32 i)
+{
+   do { i++; } while ((i < pP->nRec) && !transStart(pP->pR+i));
+   return(i);
+} // transNext
+
+// Captured transfer at i has the same message structure as m[]
+static Bool32 transMatch (const Replay *pP, U32 i, const struct i2c_msg m[], const int nM)
+{
+   const LXI2CTrcRec *pR= pP->pR + i;
+   if (pR->nMsg != nM) { return(FALSE); }
+   for (int j=0; j<nM; j++)
+   {
+      if (i >= pP->nRec) { return(FALSE); }
+      pR= pP->pR + i;
+      if ((pR->iMsg != j) || (0 != pR->off) || (pR->addr != m[j].addr) || (pR->len != m[j].len) ||
+         ((pR->flags ^ m[j].flags) & I2C_M_RD)) { return(FALSE); }
+      while ((++i < pP->nRec) && (0 != pP->pR[i].off));
+   }
+   return(TRUE);
+} // transMatch
+
+// Copy captured read data (reads) or compare (writes), returning count of differing writes
+static int transApply (const Replay *pP, U32 i, struct i2c_msg m[], const int nM)
+{
+   int nD= 0;
+   for (int j=0; j<nM; j++)
+   {
+      do
+      {
+         const LXI2CTrcRec *pR= pP->pR + i;
+         const int k= MIN(LX_I2C_TRC_NB, pR->len - pR->off);
+         if (k > 0)
+         {
+            if (m[j].flags & I2C_M_RD) { memcpy(m[j].buf + pR->off, pR->b, k); }
+            else { nD+= (0 != memcmp(m[j].buf + pR->off, pR->b, k)); }
+         }
+         i++;
+      } while ((i < pP->nRec) && (0 != pP->pR[i].off));
+   }
+   return(nD);
+} // transApply
+
+static void sleepUntilNS (const I64 t)
+{
+   RawTimeStamp ts;
+   timeSetNS(&ts, t);
+   while (EINTR == clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &ts, NULL));
+} // sleepUntilNS
+
+static int replayRDWR (const LXI2CBusCtx *pBC, struct i2c_msg m[], const int nM)
+{
+   Replay *pP= pBC->pBEC;
+   U32 i= pP->iNext;
+   int s= 0;
+   const LXI2CTrcRec *pR;
+
+   pP->stat.nTrans++;
+   while ((i < pP->nRec) && (s <= LX_I2C_REPLAY_SYNC) && !transMatch(pP, i, m, nM)) { i= transNext(pP, i); s++; }
+   if ((i >= pP->nRec) || (s > LX_I2C_REPLAY_SYNC))
+   {
+      pP->stat.nMiss++;
+      errno= ENODATA;
+      return(-1);
+   }
+   pR= pP->pR + i;
+   if (0 == (pP->flags & LX_I2C_REPLAY_FAST))
+   {
+      RawTimeStamp tE;
+      if (0 == pP->tRep0.tv_sec)
+      {
+         timeStamp(&(pP->tRep0));
+         pP->tCap0.tv_sec= pR->sBgn; pP->tCap0.tv_nsec= pR->nsBgn;
+      }
+      tE.tv_sec= pR->sEnd; tE.tv_nsec= pR->nsEnd;
+      sleepUntilNS(timeNS(&(pP->tRep0)) + timeDiffNS(&(pP->tCap0), &tE));
+   }
+   pP->stat.nWrDiff+= (transApply(pP, i, m, nM) > 0);
+   pP->stat.nSkip+= s;
+   pP->stat.nMatch++;
+   pP->iNext= transNext(pP, i);
+   if (pR->r < 0) { errno= -pR->r; return(-1); }
+   return(pR->r);
+} // replayRDWR
+
+static void replayClose (LXI2CBusCtx *pBC)
+{
+   Replay *pP= pBC->pBEC;
+   if (pP)
+   {
+      if (pP->pR) { free(pP->pR); }
+      free(pP);
+   }
+} // replayClose
+
+static const LXI2CBackend gReplayBE={ "replay", replayRDWR, replayClose };
+
+
+/***/
+
+int lxi2cReplayOpen (LXI2CBusCtx *pBC, const char path[], const U8 flags)
+{
+   LXI2CTrcHdr h;
+   Replay *pP= NULL;
+   FILE *hF= fopen(path, "rb");
+   int r= -1;
+
+   if (hF)
+   {
+      if ((1 == fread(&h, sizeof(h), 1, hF)) && (0 == memcmp(h.magic, "I2CT", 4)) &&
+         (LX_I2C_TRC_VER == h.ver) && (sizeof(LXI2CTrcRec) == h.recBytes) && (h.nRec > 0))
+      {
+         pP= calloc(1, sizeof(*pP));
+         if (pP) { pP->pR= malloc(h.nRec * sizeof(LXI2CTrcRec)); }
+         if (pP && pP->pR) { pP->nRec= fread(pP->pR, sizeof(LXI2CTrcRec), h.nRec, hF); }
+      }
+      fclose(hF);
+   }
+   if (pP && (pP->nRec > 0))
+   {  // Ring capture may begin part way through a transfer
+      pP->iNext= transStart(pP->pR) ? 0 : transNext(pP, 0);
+      pP->flags= flags;
+      pBC->flags= I2C_FUNC_I2C;
+      pBC->fd= -1;
+      pBC->clk= lxi2cClockHz(h.clk);
+      pBC->pBE= &gReplayBE;
+      pBC->pBEC= pP;
+      pBC->pTrc= NULL;
+      pBC->pPrf= NULL;
+      pBC->clkEff= 0;
+      pBC->ovhdNS= 0;
+      pBC->pPC= NULL;
+      pBC->pMP= NULL;
+      lxi2cPoolAlloc(pBC, 0);
+      r= pP->nRec;
+   }
+   else
+   {
+      ERROR_CALL("(.. %s ..) - invalid trace\n", path);
+      if (pP) { if (pP->pR) { free(pP->pR); } free(pP); }
+   }
+   return(r);
+} // lxi2cReplayOpen
+
+const LXI2CReplayStat *lxi2cReplayStat (const LXI2CBusCtx *pBC)
+{
+   if (pBC->pBE == &gReplayBE) { return &(((const Replay*)(pBC->pBEC))->stat); }
+   return(NULL);
+} // lxi2cReplayStat
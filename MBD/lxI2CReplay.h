@@ -0,0 +1,49 @@
+// Common/MBD/lxI2CReplay.h - I2C bus backend replaying a captured transaction trace
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#ifndef LX_I2C_REPLAY_H
+#define LX_I2C_REPLAY_H
+
+#include "lxI2C.h"
+
+
+/***/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Flags
+#define LX_I2C_REPLAY_FAST (1<<0)   // Ignore captured timing (maximum speed)
+
+#define LX_I2C_REPLAY_SYNC (64)     // Transfers searched ahead to re-synchronise
+
+typedef struct
+{
+   U32   nTrans;  // Transfers requested
+   U32   nMatch;  // Answered from trace
+   U32   nSkip;   // Captured transfers passed over to re-synchronise
+   U32   nWrDiff; // Matched transfers whose written bytes differ from capture
+   U32   nMiss;   // No match (failed with ENODATA)
+} LXI2CReplayStat;
+
+
+/***/
+
+// Attach trace file (from lxi2cTraceDump) as bus backend: each transfer is
+// matched (by address, direction & length of every message) against the next
+// captured transfer, read data and result being reproduced. Unless FAST, each
+// transfer completes no earlier than its captured end relative to the first.
+// Returns record count, <0 on error. Release with lxi2cClose().
+extern int lxi2cReplayOpen (LXI2CBusCtx *pBC, const char path[], const U8 flags);
+
+// Statistics (NULL if not a replay bus)
+extern const LXI2CReplayStat *lxi2cReplayStat (const LXI2CBusCtx *pBC);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // LX_I2C_REPLAY_H
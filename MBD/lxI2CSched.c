@@ -0,0 +1,172 @@
+// Common/MBD/lxI2CSched.c - earliest deadline first job scheduler for devices sharing an I2C bus
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#include <errno.h>
+#include "lxI2CSched.h"
+
+
+/***/
+
+// Sleep (absolute) to within SPIN_NS of target, then spin
+static void waitUntil (RawTimeStamp *pNow, const RawTimeStamp *pT)
+{
+   const I64 t= timeNS(pT);
+   if ((t - timeNS(pNow)) > LX_I2C_SCHED_SPIN_NS)
+   {
+      RawTimeStamp s;
+      timeSetNS(&s, t - LX_I2C_SCHED_SPIN_NS);
+      while (EINTR == clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &s, NULL));
+   }
+   do { timeStamp(pNow); } while (timeBefore(pNow, pT));
+} // waitUntil
+
+static Bool32 jobLive (const LXI2CJob *pJ) { return(NULL != pJ->fn); }
+
+// Released job with earliest deadline, else (none released) job with earliest release
+static int jobNext (const LXI2CSched *pS, const RawTimeStamp *pNow)
+{
+   int iR= -1, iW= -1;
+   for (int i=0; i<pS->nJob; i++)
+   {
+      const LXI2CJob *pJ= pS->job+i;
+      if (jobLive(pJ))
+      {
+         if (!timeBefore(pNow, &(pJ->release)))
+         {
+            if ((iR < 0) || timeBefore(&(pJ->deadline), &(pS->job[iR].deadline))) { iR= i; }
+         }
+         else if ((iW < 0) || timeBefore(&(pJ->release), &(pS->job[iW].release))) { iW= i; }
+      }
+   }
+   return((iR >= 0) ? iR : iW);
+} // jobNext
+
+static void jobRelease (LXI2CJob *pJ, const I64 rNS)
+{
+   timeSetNS(&(pJ->release), rNS);
+   timeSetNS(&(pJ->deadline), rNS + pJ->dlNS);
+} // jobRelease
+
+
+/***/
+
+void lxi2cSchedInit (LXI2CSched *pS, const LXI2CBusCtx *pBC)
+{
+   memset(pS, 0, sizeof(*pS));
+   pS->pBC= pBC;
+   timeStamp(&(pS->t0));
+} // lxi2cSchedInit
+
+int lxi2cSchedAdd (LXI2CSched *pS, const char *name, LXI2CJobFn fn, void *pCtx, const long offsetNS, const long periodNS, const long deadlineNS)
+{
+   RawTimeStamp now;
+   LXI2CJob *pJ;
+
+   if ((pS->nJob >= LX_I2C_SCHED_JOB_MAX) || (NULL == fn) || (periodNS < 0) || ((periodNS <= 0) && (deadlineNS <= 0))) { return(-1); }
+   pJ= pS->job + pS->nJob;
+   memset(pJ, 0, sizeof(*pJ));
+   pJ->fn= fn;
+   pJ->pCtx= pCtx;
+   pJ->name= name ? name : "?";
+   pJ->periodNS= periodNS;
+   pJ->dlNS= (deadlineNS > 0) ? deadlineNS : periodNS;
+   timeStamp(&now);
+   jobRelease(pJ, timeNS(&now) + offsetNS);
+   return(pS->nJob++);
+} // lxi2cSchedAdd
+
+void lxi2cSchedRemove (LXI2CSched *pS, const int iJ)
+{
+   if ((iJ >= 0) && (iJ < pS->nJob)) { pS->job[iJ].fn= NULL; }
+} // lxi2cSchedRemove
+
+int lxi2cSchedStep (LXI2CSched *pS)
+{
+   RawTimeStamp now, tE;
+   LXI2CJob *pJ;
+   I64 dNS;
+   int iJ, r;
+
+   timeStamp(&now);
+   iJ= jobNext(pS, &now);
+   if (iJ < 0) { return(-1); }
+   pJ= pS->job+iJ;
+   if (timeBefore(&now, &(pJ->release)))
+   {  // Others may be released at the same instant (or during the wait) with earlier deadline
+      const I64 t= timeNS(&now);
+      waitUntil(&now, &(pJ->release));
+      pS->sleepNS+= timeNS(&now) - t;
+      iJ= jobNext(pS, &now);
+      pJ= pS->job+iJ;
+   }
+   r= pJ->fn(pS->pBC, pJ->pCtx);
+   timeStamp(&tE);
+
+   pJ->nRun++;
+   if (r < 0) { pJ->nErr++; }
+   dNS= timeNS(&tE) - timeNS(&now);
+   pJ->sumExecNS+= dNS;
+   if (dNS > pJ->maxExecNS) { pJ->maxExecNS= dNS; }
+   dNS= timeNS(&tE) - timeNS(&(pJ->deadline));
+   if (dNS > 0)
+   {
+      pJ->nMiss++;
+      if (dNS > pJ->maxLateNS) { pJ->maxLateNS= dNS; }
+   }
+   if (pJ->periodNS <= 0) { pJ->fn= NULL; }
+   else if (jobLive(pJ))
+   {  // Next release on original phase: releases whose deadline has already passed are abandoned
+      I64 rNS= timeNS(&(pJ->release)) + pJ->periodNS;
+      const I64 eNS= timeNS(&tE);
+      if ((rNS + pJ->dlNS) < eNS)
+      {
+         const I64 n= (eNS - (rNS + pJ->dlNS)) / pJ->periodNS + 1;
+         pJ->nSkip+= n;
+         rNS+= n * pJ->periodNS;
+      }
+      jobRelease(pJ, rNS);
+   }
+   return(iJ);
+} // lxi2cSchedStep
+
+int lxi2cSchedRun (LXI2CSched *pS, const I64 durNS)
+{
+   RawTimeStamp now;
+   I64 tEnd= 0;
+   int n= 0;
+
+   timeStamp(&now);
+   if (durNS > 0) { tEnd= timeNS(&now) + durNS; }
+   pS->run= 1;
+   while (pS->run)
+   {
+      const int iJ= jobNext(pS, &now);
+      // Stop rather than wait past end
+      if ((iJ < 0) || ((tEnd > 0) && (timeNS(&(pS->job[iJ].release)) >= tEnd))) { break; }
+      if (lxi2cSchedStep(pS) < 0) { break; }
+      n++;
+      timeStamp(&now);
+   }
+   pS->run= 0;
+   return(n);
+} // lxi2cSchedRun
+
+void lxi2cSchedStop (LXI2CSched *pS) { pS->run= 0; }
+
+void lxi2cSchedDump (const LXI2CSched *pS, const U8 reportID)
+{
+   RawTimeStamp now;
+   I64 dNS;
+   timeStamp(&now);
+   dNS= timeNS(&now) - timeNS(&(pS->t0));
+   report(reportID, "I2C schedule: %.3fs, %.1f%% waiting\n", 1E-9 * dNS, (dNS > 0) ? (100.0 * pS->sleepNS) / dNS : 0);
+   for (int i=0; i<pS->nJob; i++)
+   {
+      const LXI2CJob *pJ= pS->job+i;
+      report(reportID, "\t%-8s: %u runs, %u errors, %u missed (max late %.1fus), %u skipped, exec mean %.1fus max %.1fus%s\n",
+         pJ->name, pJ->nRun, pJ->nErr, pJ->nMiss, 1E-3 * pJ->maxLateNS, pJ->nSkip,
+         (pJ->nRun > 0) ? 1E-3 * pJ->sumExecNS / pJ->nRun : 0, 1E-3 * pJ->maxExecNS, jobLive(pJ) ? "" : " (retired)");
+   }
+} // lxi2cSchedDump
@@ -0,0 +1,81 @@
+// Common/MBD/lxI2CSched.h - earliest deadline first job scheduler for devices sharing an I2C bus
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#ifndef LX_I2C_SCHED_H
+#define LX_I2C_SCHED_H
+
+#include "lxI2C.h"
+#include "lxTiming.h"
+
+
+/***/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LX_I2C_SCHED_JOB_MAX  (16)
+#define LX_I2C_SCHED_SPIN_NS  (50000) // Final approach to release is busy-wait (sleep overrun margin)
+
+// Job function: result <0 counted as error. One-shot jobs retire after running,
+// periodic jobs are re-released until lxi2cSchedRemove().
+typedef int (*LXI2CJobFn) (const LXI2CBusCtx *pBC, void *pCtx);
+
+typedef struct
+{
+   LXI2CJobFn  fn;
+   void        *pCtx;
+   const char  *name;
+   RawTimeStamp release, deadline; // Absolute: earliest start & latest completion
+   long  periodNS;   // 0 -> one-shot
+   long  dlNS;       // Deadline relative to release
+   U32   nRun, nErr;
+   U32   nMiss;      // Completed after deadline
+   U32   nSkip;      // Periodic releases abandoned after overrun
+   I64   maxLateNS, maxExecNS, sumExecNS;
+} LXI2CJob;
+
+typedef struct
+{
+   LXI2CJob job[LX_I2C_SCHED_JOB_MAX];
+   const LXI2CBusCtx *pBC;
+   RawTimeStamp t0;
+   U64   sleepNS;    // Total time waiting (sleep + spin) between jobs
+   int   nJob;
+   volatile int run;
+} LXI2CSched;
+
+
+/***/
+
+extern void lxi2cSchedInit (LXI2CSched *pS, const LXI2CBusCtx *pBC);
+
+// Register job first released offsetNS from now, then every periodNS (0 -> one-shot),
+// to complete within deadlineNS of each release (0 -> period). Returns job index
+// (<0 when full or invalid).
+extern int lxi2cSchedAdd (LXI2CSched *pS, const char *name, LXI2CJobFn fn, void *pCtx, const long offsetNS, const long periodNS, const long deadlineNS);
+
+// Retire job (not recycled until lxi2cSchedInit). May be called from a job.
+extern void lxi2cSchedRemove (LXI2CSched *pS, const int iJ);
+
+// Wait for the next release then run the released job with earliest deadline.
+// Returns job index, <0 when no jobs remain.
+extern int lxi2cSchedStep (LXI2CSched *pS);
+
+// Step until durNS elapsed (<=0 -> indefinitely), no jobs remain or lxi2cSchedStop().
+// Returns number of jobs run.
+extern int lxi2cSchedRun (LXI2CSched *pS, const I64 durNS);
+
+// Request return from lxi2cSchedRun (e.g. from signal handler or job)
+extern void lxi2cSchedStop (LXI2CSched *pS);
+
+// Report per job statistics
+extern void lxi2cSchedDump (const LXI2CSched *pS, const U8 reportID);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // LX_I2C_SCHED_H
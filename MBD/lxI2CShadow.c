@@ -0,0 +1,235 @@
+// Common/MBD/lxI2CShadow.c - write-coalescing register shadow cache for I2C devices
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#include "lxI2CShadow.h"
+
+
+/***/
+
+// Current page is cached (known & within map)
+static Bool32 cachedPage (const LXI2CShadow *pS) { return(pS->page < pS->nPage); }
+
+static U8 *valPtr (const LXI2CShadow *pS, const int reg) { return(pS->pVal + (pS->page * pS->nReg + reg) * pS->regBytes); }
+
+static U8 *statePtr (const LXI2CShadow *pS, const int reg) { return(pS->pState + pS->page * pS->nReg + reg); }
+
+// Number of whole registers covered by register-prefixed packet, or 0 if outside map
+static int regCount (const LXI2CShadow *pS, const U8 regBytes[], const U8 nRB)
+{
+   const int k= (nRB - 1) / pS->regBytes;
+   if ((k <= 0) || ((k * pS->regBytes) != (nRB - 1)) || ((regBytes[0] + k) > pS->nReg)) { return(0); }
+   if ((k > 1) && (0 == (pS->flags & LX_SHADOW_AUTOINC))) { return(0); }
+   return(k);
+} // regCount
+
+static Bool32 isPageSel (const LXI2CShadow *pS, const U8 regBytes[], const U8 nRB)
+{
+   return((pS->flags & LX_SHADOW_PAGED) && (pS->pageReg == regBytes[0]) && (2 == nRB));
+} // isPageSel
+
+// Register differs from shadow (or shadow unusable)
+static Bool32 changed (const LXI2CShadow *pS, const int reg, const U8 v[])
+{
+   const U8 s= *statePtr(pS, reg);
+   if ((s & (LX_SHADOW_VALID|LX_SHADOW_VOLATILE)) != LX_SHADOW_VALID) { return(TRUE); }
+   return(0 != memcmp(valPtr(pS, reg), v, pS->regBytes));
+} // changed
+
+// Record values now held by device (or staged when dirty != 0)
+static void store (LXI2CShadow *pS, const int reg0, const U8 v[], const int k, const U8 dirty)
+{
+   for (int i=0; i<k; i++)
+   {
+      U8 *pSt= statePtr(pS, reg0+i);
+      if (dirty)
+      {  // NB: volatile registers may be staged, but never become valid
+         memcpy(valPtr(pS, reg0+i), v + i * pS->regBytes, pS->regBytes);
+         *pSt= (*pSt & ~LX_SHADOW_VALID) | LX_SHADOW_DIRTY;
+      }
+      else if (0 == (*pSt & LX_SHADOW_VOLATILE))
+      {
+         memcpy(valPtr(pS, reg0+i), v + i * pS->regBytes, pS->regBytes);
+         *pSt= (*pSt & ~LX_SHADOW_DIRTY) | LX_SHADOW_VALID;
+      }
+   }
+} // store
+
+// Write registers [reg0, reg0+k) from values v[] as one burst
+static int writeBurst (LXI2CShadow *pS, const int reg0, const U8 v[], const int k)
+{
+   U8 b[1+LX_SHADOW_BURST_MAX];
+   const int n= k * pS->regBytes;
+   int r;
+   b[0]= reg0;
+   memcpy(b+1, v, n);
+   r= lxi2cWriteRB(pS->pBC, pS->busAddr, b, 1+n);
+   pS->nWrBus++;
+   return(r);
+} // writeBurst
+
+
+/***/
+
+int lxi2cShadowInit (LXI2CShadow *pS, const LXI2CBusCtx *pBC, const U8 busAddr, const U16 nReg, const U8 regBytes, const U8 nPage, const U8 pageReg, const U8 flags)
+{
+   memset(pS, 0, sizeof(*pS));
+   if ((nReg <= 0) || (nReg > 0x100) || (regBytes <= 0) || (regBytes > LX_SHADOW_BURST_MAX)) { return(-1); }
+   pS->pBC= pBC;
+   pS->busAddr= busAddr;
+   pS->nReg= nReg;
+   pS->regBytes= regBytes;
+   pS->flags= flags;
+   pS->pageReg= pageReg;
+   pS->nPage= (flags & LX_SHADOW_PAGED) ? MAX(1, nPage) : 1;
+   pS->page= (flags & LX_SHADOW_PAGED) ? pS->nPage : 0; // unknown until selected
+   pS->pVal= calloc(pS->nPage * nReg, regBytes);
+   pS->pState= calloc(pS->nPage * nReg, 1);
+   if (pS->pVal && pS->pState) { return(pS->nPage * nReg); }
+   lxi2cShadowRelease(pS);
+   return(-1);
+} // lxi2cShadowInit
+
+void lxi2cShadowRelease (LXI2CShadow *pS)
+{
+   if (pS->pVal) { free(pS->pVal); pS->pVal= NULL; }
+   if (pS->pState) { free(pS->pState); pS->pState= NULL; }
+} // lxi2cShadowRelease
+
+void lxi2cShadowVolatile (LXI2CShadow *pS, const U8 page, const U8 reg0, const U8 n)
+{
+   const int p0= (page < pS->nPage) ? page : 0, p1= (page < pS->nPage) ? page+1 : pS->nPage;
+   for (int p=p0; p<p1; p++)
+   {
+      U8 *pSt= pS->pState + p * pS->nReg;
+      for (int i=reg0; (i < (reg0+n)) && (i < pS->nReg); i++) { pSt[i]= LX_SHADOW_VOLATILE; }
+   }
+} // lxi2cShadowVolatile
+
+void lxi2cShadowInvalidate (LXI2CShadow *pS)
+{
+   for (int i=0; i < (pS->nPage * pS->nReg); i++) { pS->pState[i]&= LX_SHADOW_VOLATILE; }
+   if (pS->flags & LX_SHADOW_PAGED) { pS->page= pS->nPage; }
+} // lxi2cShadowInvalidate
+
+int lxi2cShadowWriteRB (LXI2CShadow *pS, const U8 regBytes[], const U8 nRB)
+{
+   int k, iF, iL, r;
+
+   if (isPageSel(pS, regBytes, nRB))
+   {
+      if (cachedPage(pS) && (regBytes[1] == pS->page)) { pS->nWrSkip++; pS->nByteSaved+= 1; return(1); }
+      r= lxi2cWriteRB(pS->pBC, pS->busAddr, regBytes, nRB);
+      pS->nWrBus++;
+      pS->page= ((r > 0) && (regBytes[1] < pS->nPage)) ? regBytes[1] : pS->nPage;
+      return(r);
+   }
+   k= cachedPage(pS) ? regCount(pS, regBytes, nRB) : 0;
+   if (k <= 0)
+   {  // Uncacheable: pass through, forgetting any registers overwritten
+      if (cachedPage(pS))
+      {
+         for (int i=regBytes[0]; (i < (regBytes[0] + (nRB-1) / pS->regBytes)) && (i < pS->nReg); i++) { *statePtr(pS, i)&= ~LX_SHADOW_VALID; }
+      }
+      pS->nWrBus++;
+      return lxi2cWriteRB(pS->pBC, pS->busAddr, regBytes, nRB);
+   }
+   // Find span of changed registers
+   for (iF= 0; (iF < k) && !changed(pS, regBytes[0]+iF, regBytes+1+iF*pS->regBytes); iF++);
+   if (iF >= k) { pS->nWrSkip++; pS->nByteSaved+= nRB-1; return(1); }
+   for (iL= k-1; (iL > iF) && !changed(pS, regBytes[0]+iL, regBytes+1+iL*pS->regBytes); iL--);
+
+   store(pS, regBytes[0], regBytes+1, k, 0); // NB: provisional, invalidated on failure
+   if (((iF > 0) || (iL < (k-1))) && (((iL-iF+1) * pS->regBytes) <= LX_SHADOW_BURST_MAX))
+   {
+      r= writeBurst(pS, regBytes[0]+iF, regBytes+1+iF*pS->regBytes, iL-iF+1); // NB: volatile values not held in shadow
+      pS->nByteSaved+= (k - (iL-iF+1)) * pS->regBytes;
+   }
+   else
+   {
+      r= lxi2cWriteRB(pS->pBC, pS->busAddr, regBytes, nRB);
+      pS->nWrBus++;
+   }
+   if (r < 0)
+   {
+      for (int i=0; i<k; i++) { *statePtr(pS, regBytes[0]+i)&= ~LX_SHADOW_VALID; }
+   }
+   return(r);
+} // lxi2cShadowWriteRB
+
+int lxi2cShadowReadRB (LXI2CShadow *pS, U8 regBytes[], const U8 nRB)
+{
+   int k, i, r;
+
+   if (isPageSel(pS, regBytes, nRB) && cachedPage(pS))
+   {
+      regBytes[1]= pS->page;
+      pS->nRdHit++;
+      return(2);
+   }
+   k= cachedPage(pS) ? regCount(pS, regBytes, nRB) : 0;
+   for (i=0; i<k; i++)
+   {
+      if ((*statePtr(pS, regBytes[0]+i) & (LX_SHADOW_VALID|LX_SHADOW_VOLATILE)) != LX_SHADOW_VALID) { break; }
+   }
+   if ((k > 0) && (i >= k))
+   {
+      memcpy(regBytes+1, valPtr(pS, regBytes[0]), nRB-1);
+      pS->nRdHit++;
+      pS->nByteSaved+= nRB-1;
+      return(2); // as ioctl message count
+   }
+   r= lxi2cReadRB(pS->pBC, pS->busAddr, regBytes, nRB);
+   pS->nRdBus++;
+   if (r >= 0)
+   {
+      if (isPageSel(pS, regBytes, nRB)) { pS->page= (regBytes[1] < pS->nPage) ? regBytes[1] : pS->nPage; }
+      for (i=0; i<k; i++)
+      {  // NB: staged (dirty) values retained
+         if (0 == (*statePtr(pS, regBytes[0]+i) & LX_SHADOW_DIRTY)) { store(pS, regBytes[0]+i, regBytes+1+i*pS->regBytes, 1, 0); }
+      }
+   }
+   return(r);
+} // lxi2cShadowReadRB
+
+int lxi2cShadowSet (LXI2CShadow *pS, const U8 regBytes[], const U8 nRB)
+{
+   const int k= cachedPage(pS) ? regCount(pS, regBytes, nRB) : 0;
+   int n= 0;
+   if (k <= 0) { return(-1); }
+   for (int i=0; i<k; i++)
+   {
+      const U8 *pV= regBytes + 1 + i * pS->regBytes;
+      if (changed(pS, regBytes[0]+i, pV)) { store(pS, regBytes[0]+i, pV, 1, 1); n++; }
+   }
+   return(n);
+} // lxi2cShadowSet
+
+int lxi2cShadowFlush (LXI2CShadow *pS)
+{
+   const int maxRun= (pS->flags & LX_SHADOW_AUTOINC) ? (LX_SHADOW_BURST_MAX / pS->regBytes) : 1;
+   int i= 0, n= 0, r= 0;
+
+   if (!cachedPage(pS)) { return(0); }
+   while (i < pS->nReg)
+   {
+      if (*statePtr(pS, i) & LX_SHADOW_DIRTY)
+      {
+         int k= 1;
+         while ((k < maxRun) && ((i+k) < pS->nReg) && (*statePtr(pS, i+k) & LX_SHADOW_DIRTY)) { k++; }
+         r= writeBurst(pS, i, valPtr(pS, i), k);
+         if (r < 0) { return(r); }
+         for (int j=0; j<k; j++)
+         {
+            U8 *pSt= statePtr(pS, i+j);
+            *pSt&= ~LX_SHADOW_DIRTY;
+            if (0 == (*pSt & LX_SHADOW_VOLATILE)) { *pSt|= LX_SHADOW_VALID; }
+         }
+         n++;
+         i+= k;
+      }
+      else { i++; }
+   }
+   return(n);
+} // lxi2cShadowFlush
@@ -0,0 +1,72 @@
+// Common/MBD/lxI2CShadow.h - write-coalescing register shadow cache for I2C devices
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#ifndef LX_I2C_SHADOW_H
+#define LX_I2C_SHADOW_H
+
+#include "lxI2C.h"
+
+
+/***/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Per register state (per page)
+#define LX_SHADOW_VALID    (1<<0)   // Shadow holds device value
+#define LX_SHADOW_DIRTY    (1<<1)   // Staged value awaiting flush
+#define LX_SHADOW_VOLATILE (1<<2)   // Never cached: status, read-only or side-effect on write
+
+// Device flags
+#define LX_SHADOW_AUTOINC  (1<<0)   // Device auto-increments register address (burst access)
+#define LX_SHADOW_PAGED    (1<<1)   // Register page (bank) selected by pageReg
+
+#define LX_SHADOW_BURST_MAX (192)   // Max payload bytes of a merged (copied) burst write
+
+// Shadow of a device register map: nReg registers of regBytes each, replicated
+// for nPage pages when the device selects banks via a page register.
+typedef struct
+{
+   const LXI2CBusCtx *pBC;
+   U8    *pVal;      // Values [nPage][nReg][regBytes]
+   U8    *pState;    // LX_SHADOW_* state [nPage][nReg]
+   U16   nReg;
+   U8    busAddr, regBytes, nPage;
+   U8    flags, pageReg, page; // page currently selected (nPage if unknown)
+   U32   nWrSkip, nWrBus, nRdHit, nRdBus; // Transactions avoided / made
+   U32   nByteSaved;   // Payload bytes not transferred
+} LXI2CShadow;
+
+
+/***/
+
+// Allocate shadow (initially invalid). For unpaged devices nPage=1 & pageReg ignored.
+extern int lxi2cShadowInit (LXI2CShadow *pS, const LXI2CBusCtx *pBC, const U8 busAddr, const U16 nReg, const U8 regBytes, const U8 nPage, const U8 pageReg, const U8 flags);
+extern void lxi2cShadowRelease (LXI2CShadow *pS);
+
+// Declare n registers from reg0 volatile on page (all pages if page >= nPage)
+extern void lxi2cShadowVolatile (LXI2CShadow *pS, const U8 page, const U8 reg0, const U8 n);
+
+// Forget all cached values (e.g. after device reset)
+extern void lxi2cShadowInvalidate (LXI2CShadow *pS);
+
+// Drop-in for lxi2cWriteRB(): writes only the span of registers differing from the
+// shadow (nothing at all if unchanged). Page register writes track page selection.
+extern int lxi2cShadowWriteRB (LXI2CShadow *pS, const U8 regBytes[], const U8 nRB);
+
+// Drop-in for lxi2cReadRB(): answered locally if every register is valid & non-volatile
+extern int lxi2cShadowReadRB (LXI2CShadow *pS, U8 regBytes[], const U8 nRB);
+
+// Deferred write: stage values (marking changed registers dirty) then flush
+// dirty registers of the current page, merging adjacent ones into bursts.
+extern int lxi2cShadowSet (LXI2CShadow *pS, const U8 regBytes[], const U8 nRB);
+extern int lxi2cShadowFlush (LXI2CShadow *pS);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // LX_I2C_SHADOW_H
@@ -0,0 +1,585 @@
+// Common/MBD/lxI2CSim.c - in-process simulated I2C bus & device models (hardware free testing)
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include "lxI2CSim.h"
+#include "lxTiming.h"
+
+
+/***/
+
+#define SIM_WR_MAX   (512) // Max bytes of a (NOSTART joined) write
+
+typedef struct sim_dev SimDev;
+
+// Device model: messages arrive with the time (ns relative to bus open) at which
+// their data phase begins. Read fills all n bytes (as a real slave must).
+struct sim_dev
+{
+   void  (*write) (SimDev *pD, const U8 b[], const int n, const U64 t);
+   void  (*read) (SimDev *pD, U8 b[], const int n, const U64 t);
+   U8    busAddr;
+};
+
+typedef struct
+{
+   pthread_mutex_t lock;   // NB: bus shared by threads is serialised, as by the kernel
+   SimDev   *pD[LX_I2C_SIM_DEV_MAX];
+   LXI2CSimStat stat;
+   U64   t0, tFree;  // Reference (open) & bus free times (absolute ns)
+   long  ovhdNS;
+   int   clk, nDev;
+   U8    flags;
+} SimBus;
+
+static U64 nsNow (void)
+{
+   RawTimeStamp t;
+   timeStamp(&t);
+   return timeNS(&t);
+} // nsNow
+
+static U64 clkNS (const SimBus *pS, const U64 nClk) { return((nClk * NANO_TICKS) / pS->clk); }
+
+static SimDev *findDev (const SimBus *pS, const U16 busAddr)
+{
+   for (int i=0; i<pS->nDev; i++) { if (pS->pD[i]->busAddr == busAddr) { return(pS->pD[i]); } }
+   return(NULL);
+} // findDev
+
+static U16 rdU16LE (const U8 b[]) { return(b[0] | (b[1] << 8)); }
+
+
+/***/
+
+static int simRDWR (const LXI2CBusCtx *pBC, struct i2c_msg m[], const int nM)
+{
+   SimBus *pS= pBC->pBEC;
+   U8 wb[SIM_WR_MAX];
+   U64 t, nClk= 0;
+   int i= 0, r= nM, e= ENXIO;
+
+   if ((nM <= 0) || (nM > LX_I2C_RDWR_MAX)) { errno= EINVAL; return(-1); }
+   pthread_mutex_lock(&(pS->lock));
+   t= nsNow() + pS->ovhdNS;
+   if (t < pS->tFree) { t= pS->tFree; }
+   while (i < nM)
+   {
+      SimDev *pD= findDev(pS, m[i].addr);
+      if (NULL == pD)
+      {  // Address phase only, then STOP
+         nClk+= I2C_ADDR_BITS_NCLK(8,0);
+         pS->stat.nNAK++;
+         r= -1;
+         break;
+      }
+      nClk+= I2C_ADDR_BITS_NCLK(8,0);
+      if (m[i].flags & I2C_M_RD)
+      {
+         pD->read(pD, m[i].buf, m[i].len, t + clkNS(pS, nClk) - pS->t0);
+         nClk+= 9 * m[i].len;
+         i++;
+      }
+      else
+      {  // Join write continuations (no repeated START) into one device write
+         int n= m[i].len, j= i+1;
+         const U8 *pB= m[i].buf;
+         if ((j < nM) && (m[j].flags & I2C_M_NOSTART))
+         {
+            int nJ= n, k= j;
+            while ((k < nM) && (m[k].flags & I2C_M_NOSTART) && !(m[k].flags & I2C_M_RD)) { nJ+= m[k++].len; }
+            if (nJ > SIM_WR_MAX)
+            {  // Reject (as for the kernel's own message limits) rather than truncate
+               r= -1; e= EINVAL;
+               break;
+            }
+            memcpy(wb, m[i].buf, n);
+            for (; j<k; j++) { memcpy(wb+n, m[j].buf, m[j].len); n+= m[j].len; }
+            pB= wb;
+         }
+         nClk+= 9 * n;
+         pD->write(pD, pB, n, t + clkNS(pS, nClk) - pS->t0);
+         i= j;
+      }
+   }
+   pS->stat.nTrans++;
+   pS->stat.nMsg+= i;
+   pS->stat.nClk+= nClk;
+   pS->stat.busNS+= clkNS(pS, nClk);
+   pS->tFree= t + clkNS(pS, nClk);
+   t= pS->tFree;
+   pthread_mutex_unlock(&(pS->lock));
+
+   if (0 == (pS->flags & LX_I2C_SIM_NOWAIT)) { while (nsNow() < t); }
+   if (r < 0) { errno= e; }
+   return(r);
+} // simRDWR
+
+static void simClose (LXI2CBusCtx *pBC)
+{
+   SimBus *pS= pBC->pBEC;
+   if (pS)
+   {
+      for (int i=0; i<pS->nDev; i++) { free(pS->pD[i]); }
+      pthread_mutex_destroy(&(pS->lock));
+      free(pS);
+   }
+} // simClose
+
+static const LXI2CBackend gSimBE={ "sim", simRDWR, simClose };
+
+static SimBus *simBus (const LXI2CBusCtx *pBC) { return((pBC->pBE == &gSimBE) ? pBC->pBEC : NULL); }
+
+// Register device model (allocated by caller, freed on close)
+static int addDev (LXI2CBusCtx *pBC, SimDev *pD)
+{
+   SimBus *pS= simBus(pBC);
+   int r= -1;
+   if (pS && pD)
+   {
+      pthread_mutex_lock(&(pS->lock));
+      if ((pS->nDev < LX_I2C_SIM_DEV_MAX) && (NULL == findDev(pS, pD->busAddr)))
+      {
+         pS->pD[pS->nDev]= pD;
+         r= ++(pS->nDev);
+      }
+      pthread_mutex_unlock(&(pS->lock));
+   }
+   if (r < 0) { free(pD); }
+   return(r);
+} // addDev
+
+
+/*** ADS1015 / ADS1115 ***/
+
+typedef struct
+{
+   SimDev d;
+   U64   tConv;   // Single shot: completion, continuous: start
+   U16   cfg, lo, hi;
+   I16   res;
+   U8    ptr, hwID, busy;
+} SimADS;
+
+static const U16 gADSRate[2][8]=
+{
+   { 128, 250, 490, 920, 1600, 2400, 3300, 3300 },
+   { 8, 16, 32, 64, 128, 250, 475, 860 }
+};
+static const F32 gADSFSV[8]= { 6.144, 4.096, 2.048, 1.024, 0.512, 0.256, 0.256, 0.256 };
+
+// Synthetic input: channel c offset 0.5*(c+1)V, 0.25V sinusoid at 0.5*(c+1)Hz
+static F64 adsAIN (const int c, const U64 t)
+{
+   return(0.5 * (c+1) + 0.25 * sin(M_PI * (c+1) * (1E-9 * t)));
+} // adsAIN
+
+static I16 adsSample (const SimADS *pA, const U64 t)
+{
+   static const I8 mux[8][2]= { {0,1}, {0,3}, {1,3}, {2,3}, {0,-1}, {1,-1}, {2,-1}, {3,-1} };
+   const I8 *pM= mux[(pA->cfg >> 12) & 0x7];
+   F64 v= adsAIN(pM[0], t);
+   I32 r;
+   if (pM[1] >= 0) { v-= adsAIN(pM[1], t); }
+   r= lrint(v * 32768 / gADSFSV[(pA->cfg >> 9) & 0x7]);
+   if (r > 0x7FFF) { r= 0x7FFF; } else if (r < -0x8000) { r= -0x8000; }
+   if (0 == pA->hwID) { r&= ~0xF; } // 12b left aligned
+   return(r);
+} // adsSample
+
+static U64 adsConvNS (const SimADS *pA) { return(NANO_TICKS / gADSRate[pA->hwID][(pA->cfg >> 5) & 0x7]); }
+
+// Bring conversion result up to date
+static void adsUpdate (SimADS *pA, const U64 t)
+{
+   if (pA->cfg & 0x100)
+   {  // single shot
+      if (pA->busy && (t >= pA->tConv)) { pA->res= adsSample(pA, pA->tConv); pA->busy= 0; }
+   }
+   else
+   {  // continuous: latest completed conversion
+      const U64 c= adsConvNS(pA);
+      if (t >= (pA->tConv + c)) { pA->res= adsSample(pA, pA->tConv + ((t - pA->tConv) / c) * c); }
+   }
+} // adsUpdate
+
+static void adsWrite (SimDev *pD, const U8 b[], const int n, const U64 t)
+{
+   SimADS *pA= (void*)pD;
+   if (n <= 0) { return; }
+   adsUpdate(pA, t);
+   pA->ptr= b[0] & 0x3;
+   if (n >= 3)
+   {
+      const U16 v= (b[1] << 8) | b[2];
+      switch(pA->ptr)
+      {
+         case 1 :
+            pA->cfg= v & 0x7FFF;
+            if (v & 0x100)
+            {
+               if (v & 0x8000) { pA->tConv= t + adsConvNS(pA); pA->busy= 1; }
+            }
+            else { pA->tConv= t; pA->busy= 0; }
+            break;
+         case 2 : pA->lo= v; break;
+         case 3 : pA->hi= v; break;
+      }
+   }
+} // adsWrite
+
+static void adsRead (SimDev *pD, U8 b[], const int n, const U64 t)
+{
+   SimADS *pA= (void*)pD;
+   U16 v= 0;
+   adsUpdate(pA, t);
+   switch(pA->ptr)
+   {
+      case 0 : v= pA->res; break;
+      case 1 : v= pA->cfg | (((pA->cfg & 0x100) && !pA->busy) << 15); break;
+      case 2 : v= pA->lo; break;
+      case 3 : v= pA->hi; break;
+   }
+   for (int i=0; i<n; i++) { b[i]= (i & 1) ? (v & 0xFF) : (v >> 8); }
+} // adsRead
+
+int lxi2cSimAddADS (LXI2CBusCtx *pBC, const U8 busAddr, const U8 hwID)
+{
+   SimADS *pA= calloc(1, sizeof(*pA));
+   if (pA)
+   {
+      pA->d= (SimDev){ adsWrite, adsRead, busAddr };
+      pA->hwID= (0 != hwID);
+      pA->cfg= 0x0583; // power-on default (OS bit reflected on read)
+      pA->lo= 0x8000;
+      pA->hi= 0x7FFF;
+   }
+   return addDev(pBC, (void*)pA);
+} // lxi2cSimAddADS
+
+
+/*** u-blox M8 DDC ***/
+
+#define SIM_UBX_NB (4096)
+
+typedef struct
+{
+   SimDev d;
+   U64   tNext, ivl;    // Periodic message schedule
+   U16   iR, nQ;        // Output ring read index & byte count
+   U8    ptr;
+   U8    q[SIM_UBX_NB];
+} SimUBX;
+
+// Append UBX frame (dropped if no room, as when the receiver TX buffer overflows)
+static void ubxQueue (SimUBX *pU, const U8 cls, const U8 id, const U8 pld[], const U16 n)
+{
+   U8 h[6]= { 0xB5, 0x62, cls, id, n & 0xFF, n >> 8 };
+   U8 a= 0, b= 0;
+   if ((pU->nQ + 8 + n) > SIM_UBX_NB) { return; }
+   for (int i=0; i<(6+n+2); i++)
+   {
+      U8 x;
+      if (i < 6) { x= h[i]; }
+      else if (i < (6+n)) { x= pld[i-6]; }
+      else { x= (i == (6+n)) ? a : b; }
+      if ((i >= 2) && (i < (6+n))) { a+= x; b+= a; }
+      pU->q[(pU->iR + pU->nQ++) % SIM_UBX_NB]= x;
+   }
+} // ubxQueue
+
+static void wrU32LE (U8 b[], const U32 v) { b[0]= v; b[1]= v >> 8; b[2]= v >> 16; b[3]= v >> 24; }
+
+// NAV-TIMEUTC for each elapsed interval
+static void ubxUpdate (SimUBX *pU, const U64 t)
+{
+   while (t >= pU->tNext)
+   {
+      const U32 s= pU->tNext / NANO_TICKS;
+      U8 p[20];
+      wrU32LE(p+0, (pU->tNext / 1000000) % (7*24*3600*1000)); // iTOW
+      wrU32LE(p+4, 50); // tAcc
+      wrU32LE(p+8, pU->tNext % NANO_TICKS);
+      p[12]= 2021 & 0xFF; p[13]= 2021 >> 8; p[14]= 9; p[15]= 1 + (s / 86400) % 30;
+      p[16]= (s / 3600) % 24; p[17]= (s / 60) % 60; p[18]= s % 60;
+      p[19]= 0x07; // valid TOW, WKN, UTC
+      ubxQueue(pU, 0x01, 0x21, p, sizeof(p));
+      pU->tNext+= pU->ivl;
+   }
+} // ubxUpdate
+
+static void ubxWrite (SimDev *pD, const U8 b[], const int n, const U64 t)
+{
+   SimUBX *pU= (void*)pD;
+   int i= 0;
+   if (n <= 0) { return; }
+   if (b[0] >= 0xFD) { pU->ptr= b[0]; i= 1; } // register address (optionally followed by stream data)
+   while ((i + 8) <= n)
+   {  // Complete frames only
+      const U16 l= rdU16LE(b+i+4);
+      if ((0xB5 != b[i]) || (0x62 != b[i+1]) || ((i + 8 + l) > n)) { break; }
+      if (0x06 == b[i+2])
+      {  // CFG: ACK-ACK
+         ubxQueue(pU, 0x05, 0x01, b+i+2, 2);
+      }
+      else if ((0x0A == b[i+2]) && (0x04 == b[i+3]) && (0 == l))
+      {  // MON-VER poll
+         U8 p[30+10+30];
+         memset(p, 0, sizeof(p));
+         strcpy((char*)p, "ROM CORE 3.01 (107888)");
+         strcpy((char*)p+30, "00080000");
+         strcpy((char*)p+40, "PROTVER=18.00");
+         ubxQueue(pU, 0x0A, 0x04, p, sizeof(p));
+      }
+      i+= 8 + l;
+   }
+} // ubxWrite
+
+static void ubxRead (SimDev *pD, U8 b[], const int n, const U64 t)
+{
+   SimUBX *pU= (void*)pD;
+   ubxUpdate(pU, t);
+   for (int i=0; i<n; i++)
+   {
+      switch(pU->ptr)
+      {
+         case 0xFD : b[i]= pU->nQ >> 8; pU->ptr= 0xFE; break;
+         case 0xFE : b[i]= pU->nQ & 0xFF; pU->ptr= 0xFF; break;
+         default :
+            if (pU->nQ > 0)
+            {
+               b[i]= pU->q[pU->iR];
+               pU->iR= (pU->iR + 1) % SIM_UBX_NB;
+               pU->nQ--;
+            }
+            else { b[i]= 0xFF; } // no data
+            pU->ptr= 0xFF;
+            break;
+      }
+   }
+} // ubxRead
+
+int lxi2cSimAddUBX (LXI2CBusCtx *pBC, const U8 busAddr, const long ivlNS)
+{
+   SimUBX *pU= calloc(1, sizeof(*pU));
+   if (pU)
+   {
+      pU->d= (SimDev){ ubxWrite, ubxRead, busAddr };
+      pU->ivl= (ivlNS > 0) ? ivlNS : NANO_TICKS;
+      pU->tNext= pU->ivl;
+      pU->ptr= 0xFF;
+   }
+   return addDev(pBC, (void*)pU);
+} // lxi2cSimAddUBX
+
+
+/*** IS31FL3731 ***/
+
+#define SIM_LED_PAGES   (12)  // frames 0..7, (gap), control page 0xB
+#define SIM_LED_PAGE_REG (0xFD)
+
+typedef struct
+{
+   SimDev d;
+   U8    ptr, page;
+   U8    m[SIM_LED_PAGES][0x100];
+} SimLED;
+
+static void ledWrite (SimDev *pD, const U8 b[], const int n, const U64 t)
+{
+   SimLED *pL= (void*)pD;
+   if (n <= 0) { return; }
+   pL->ptr= b[0];
+   for (int i=1; i<n; i++)
+   {
+      if (SIM_LED_PAGE_REG == pL->ptr) { if (b[i] < SIM_LED_PAGES) { pL->page= b[i]; } }
+      else if (!((0xB == pL->page) && (0x07 == pL->ptr))) { pL->m[pL->page][pL->ptr]= b[i]; } // NB: frame state read-only
+      pL->ptr++;
+   }
+} // ledWrite
+
+static void ledRead (SimDev *pD, U8 b[], const int n, const U64 t)
+{
+   SimLED *pL= (void*)pD;
+   for (int i=0; i<n; i++)
+   {
+      if (SIM_LED_PAGE_REG == pL->ptr) { b[i]= pL->page; }
+      else if ((0xB == pL->page) && (0x07 == pL->ptr)) { b[i]= pL->m[0xB][0x01] & 0x7; } // frame displayed (picture mode)
+      else { b[i]= pL->m[pL->page][pL->ptr]; }
+      pL->ptr++;
+   }
+} // ledRead
+
+int lxi2cSimAddLED (LXI2CBusCtx *pBC, const U8 busAddr)
+{
+   SimLED *pL= calloc(1, sizeof(*pL));
+   if (pL) { pL->d= (SimDev){ ledWrite, ledRead, busAddr }; }
+   return addDev(pBC, (void*)pL);
+} // lxi2cSimAddLED
+
+
+/*** BNO08x SHTP ***/
+
+#define SIM_BNO_PKT_MAX (8)
+#define SIM_BNO_PLD_MAX (64)
+
+typedef struct { U16 n; U8 chan, b[SIM_BNO_PLD_MAX]; } SimSHTPPkt;
+
+typedef struct
+{
+   SimDev d;
+   SimSHTPPkt q[SIM_BNO_PKT_MAX];
+   U64   tNext, ivl;    // Input report schedule (ivl == 0 -> disabled)
+   U16   iPld;          // Payload bytes of head packet already read
+   U8    iQ, nQ, hdrSent;
+   U8    rptID, rptSeq;
+   U8    seq[6];        // Per channel (transmit) sequence
+} SimBNO;
+
+static void bnoQueue (SimBNO *pB, const U8 chan, const U8 pld[], const U16 n)
+{
+   if ((pB->nQ < SIM_BNO_PKT_MAX) && (n <= SIM_BNO_PLD_MAX))
+   {
+      SimSHTPPkt *pP= pB->q + (pB->iQ + pB->nQ++) % SIM_BNO_PKT_MAX;
+      pP->n= n;
+      pP->chan= chan;
+      memcpy(pP->b, pld, n);
+   }
+} // bnoQueue
+
+static void bnoReset (SimBNO *pB)
+{
+   static const U8 adv[]=
+   {  // TLV: GUID, MaxW, MaxR, MaxTW, MaxTR, app & channel names
+      1, 4, 1, 0, 0, 0,   2, 2, 0x00, 0x01,   3, 2, 0x00, 0x01,   4, 2, 0x80, 0x00,   5, 2, 0x80, 0x00,
+      8, 5, 'S', 'H', 'T', 'P', 0,   9, 8, 'c', 'o', 'n', 't', 'r', 'o', 'l', 0
+   };
+   static const U8 rstDone[]= { 0x01 };
+   pB->nQ= pB->iQ= 0;
+   pB->iPld= pB->hdrSent= 0;
+   pB->ivl= 0;
+   memset(pB->seq, 0, sizeof(pB->seq));
+   bnoQueue(pB, 0, adv, sizeof(adv));
+   bnoQueue(pB, 1, rstDone, sizeof(rstDone));
+} // bnoReset
+
+static void bnoWrite (SimDev *pD, const U8 b[], const int n, const U64 t)
+{
+   SimBNO *pB= (void*)pD;
+   const U8 *pld= b+4;
+   int l;
+   if (n < 5) { return; }
+   l= MIN(n, rdU16LE(b) & 0x7FFF) - 4;
+   if ((1 == b[2]) && (0x01 == pld[0])) { bnoReset(pB); }
+   else if (2 == b[2])
+   {
+      if (0xF9 == pld[0])
+      {  // Product ID response
+         static const U8 id[16]= { 0xF8, 0x01, 3, 2, 0x98, 0xA4, 0x98, 0x00, 0x72, 0x01, 0, 0, 0x05, 0, 0, 0 };
+         bnoQueue(pB, 2, id, sizeof(id));
+      }
+      else if ((0xFD == pld[0]) && (l >= 17))
+      {  // Set feature: report interval (us) then Get Feature Response
+         U8 r[17];
+         pB->rptID= pld[1];
+         pB->ivl= 1000ULL * (pld[5] | (pld[6] << 8) | (pld[7] << 16) | ((U32)pld[8] << 24));
+         pB->tNext= t + pB->ivl;
+         memcpy(r, pld, sizeof(r));
+         r[0]= 0xFC;
+         bnoQueue(pB, 2, r, sizeof(r));
+      }
+   }
+} // bnoWrite
+
+static void bnoUpdate (SimBNO *pB, const U64 t)
+{
+   if ((pB->ivl > 0) && (t >= pB->tNext))
+   {  // Timebase reference then (unit quaternion, slowly rotating about Z) report
+      const F64 a= 0.5 * (1E-9 * pB->tNext);
+      const I16 qk= lrint(16384 * sin(a)), qr= lrint(16384 * cos(a));
+      const U32 dt= (t - pB->tNext) / 100000; // 100us units
+      U8 p[5+14]= { 0xFB, dt, dt >> 8, dt >> 16, dt >> 24, pB->rptID, pB->rptSeq++, 0x03, 0,
+         0, 0, 0, 0, qk & 0xFF, qk >> 8, qr & 0xFF, qr >> 8, 0, 0 };
+      bnoQueue(pB, 3, p, sizeof(p));
+      pB->tNext+= pB->ivl;
+      if (pB->tNext <= t) { pB->tNext= t + pB->ivl; } // reader too slow: reports lost
+   }
+} // bnoUpdate
+
+// Reads return a header then payload: a packet larger than the read continues
+// in subsequent reads, each with a fresh header (continuation flag set).
+static void bnoRead (SimDev *pD, U8 b[], const int n, const U64 t)
+{
+   SimBNO *pB= (void*)pD;
+   int k= 0;
+   memset(b, 0, n);
+   bnoUpdate(pB, t);
+   if ((pB->nQ > 0) && (n >= 4))
+   {
+      SimSHTPPkt *pP= pB->q + pB->iQ;
+      const U16 rem= pP->n - pB->iPld;
+      k= MIN(rem, n-4);
+      b[0]= (4 + rem) & 0xFF;
+      b[1]= ((4 + rem) >> 8) | (pB->hdrSent ? 0x80 : 0);
+      b[2]= pP->chan;
+      b[3]= pB->seq[pP->chan];
+      if (!pB->hdrSent) { pB->seq[pP->chan]++; pB->hdrSent= 1; }
+      memcpy(b+4, pP->b + pB->iPld, k);
+      pB->iPld+= k;
+      if (pB->iPld >= pP->n)
+      {
+         pB->iQ= (pB->iQ + 1) % SIM_BNO_PKT_MAX;
+         pB->nQ--;
+         pB->iPld= pB->hdrSent= 0;
+      }
+   }
+} // bnoRead
+
+int lxi2cSimAddBNO (LXI2CBusCtx *pBC, const U8 busAddr)
+{
+   SimBNO *pB= calloc(1, sizeof(*pB));
+   if (pB)
+   {
+      pB->d= (SimDev){ bnoWrite, bnoRead, busAddr };
+      bnoReset(pB); // power-on advertisement pending
+   }
+   return addDev(pBC, (void*)pB);
+} // lxi2cSimAddBNO
+
+
+/***/
+
+Bool32 lxi2cSimOpen (LXI2CBusCtx *pBC, const int clk, const long ovhdNS, const U8 flags)
+{
+   SimBus *pS= calloc(1, sizeof(*pS));
+   if (NULL == pS) { return(FALSE); }
+   pthread_mutex_init(&(pS->lock), NULL);
+   pS->clk= lxi2cClockHz(clk);
+   pS->ovhdNS= MAX(0, ovhdNS);
+   pS->flags= flags;
+   pS->t0= pS->tFree= nsNow();
+   pBC->flags= I2C_FUNC_I2C;
+   pBC->fd= -1;
+   pBC->clk= pS->clk;
+   pBC->pBE= &gSimBE;
+   pBC->pBEC= pS;
+   pBC->pTrc= NULL;
+   pBC->pPrf= NULL;
+   pBC->clkEff= 0;
+   pBC->ovhdNS= 0;
+   pBC->pPC= NULL;
+   pBC->pMP= NULL;
+   lxi2cPoolAlloc(pBC, 0);
+   return(TRUE);
+} // lxi2cSimOpen
+
+const LXI2CSimStat *lxi2cSimStat (const LXI2CBusCtx *pBC)
+{
+   const SimBus *pS= simBus(pBC);
+   if (pS) { return &(pS->stat); }
+   return(NULL);
+} // lxi2cSimStat
@@ -0,0 +1,56 @@
+// Common/MBD/lxI2CSim.h - in-process simulated I2C bus & device models (hardware free testing)
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#ifndef LX_I2C_SIM_H
+#define LX_I2C_SIM_H
+
+#include "lxI2C.h"
+
+
+/***/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LX_I2C_SIM_DEV_MAX (8)
+
+// Bus flags
+#define LX_I2C_SIM_NOWAIT  (1<<0)   // Return immediately (do not wait for modelled bus time)
+
+typedef struct
+{
+   U32   nTrans, nMsg, nNAK;  // Transfers, messages, address not acknowledged
+   U64   nClk;    // Bus clocks consumed (I2C_ADDR_BITS_NCLK model)
+   U64   busNS;   // Modelled bus busy time
+} LXI2CSimStat;
+
+
+/***/
+
+// Attach simulated bus (no devices) to context, replacing the kernel backend. Bus
+// timing follows clock rate (as lxi2cOpen) plus per transfer overhead (software
+// & driver latency). Release with lxi2cClose().
+extern Bool32 lxi2cSimOpen (LXI2CBusCtx *pBC, const int clk, const long ovhdNS, const U8 flags);
+
+// Add device models, returning device count (<0 on error: bus full or address in use)
+// ADS1015 (hwID=0) / ADS1115 (hwID=1): timed single-shot & continuous conversion
+// of a synthetic input per channel (slow sinusoid, distinct offset & frequency).
+extern int lxi2cSimAddADS (LXI2CBusCtx *pBC, const U8 busAddr, const U8 hwID);
+// u-blox M8 DDC port: NAV-TIMEUTC every ivlNS (<=0 -> 1sec), CFG messages ACKed, MON-VER poll answered.
+extern int lxi2cSimAddUBX (LXI2CBusCtx *pBC, const U8 busAddr, const long ivlNS);
+// IS31FL3731 matrix driver: 8 frame pages + control page, auto-increment.
+extern int lxi2cSimAddLED (LXI2CBusCtx *pBC, const U8 busAddr);
+// BNO08x SHTP: reset -> advertisement, product ID, feature enable -> periodic rotation vector.
+extern int lxi2cSimAddBNO (LXI2CBusCtx *pBC, const U8 busAddr);
+
+// Statistics (NULL if not a simulated bus)
+extern const LXI2CSimStat *lxi2cSimStat (const LXI2CBusCtx *pBC);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // LX_I2C_SIM_H
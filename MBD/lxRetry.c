@@ -0,0 +1,110 @@
+// Common/MBD/lxRetry.c - retry & backoff policy with latency accounting for bus transactions
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#include <errno.h>
+#include "lxRetry.h"
+
+
+/***/
+
+static U64 backoffNS (LXRetry *pR)
+{
+   const LXRetryPolicy *pP= pR->pP;
+   U64 ns= pP->baseNS;
+
+   if (LX_RETRY_FIXED != pP->mode)
+   {
+      ns<<= MIN(pR->nTry, 31); // NB: cannot overflow U64 (base is U32)
+      if ((pP->maxNS > 0) && (ns > pP->maxNS)) { ns= pP->maxNS; }
+      if (LX_RETRY_JITTER == pP->mode) { ns= (ns >> 1) + ((ns >> 1) * (rand_r(&(pR->seed)) & 0xFFFF) >> 16); }
+   }
+   return(ns);
+} // backoffNS
+
+static void sleepNS (const U64 ns)
+{
+   struct timespec ts= { ns / NANO_TICKS, ns % NANO_TICKS };
+   while (EINTR == clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, &ts));
+} // sleepNS
+
+
+/***/
+
+int lxRetryClass (const int err)
+{
+   switch(err)
+   {
+      case 0 :
+      case EAGAIN :
+      case EBUSY :
+      case EINTR :
+         return(LX_RETRY_AGAIN);
+      case EREMOTEIO :
+      case ENXIO :
+         return(LX_RETRY_NAK);
+      case ETIMEDOUT :
+         return(LX_RETRY_TIMEOUT);
+   }
+   return(LX_RETRY_OTHER);
+} // lxRetryClass
+
+void lxRetryBegin (LXRetry *pR, const LXRetryPolicy *pP, LXRetryStat *pS)
+{
+   memset(pR, 0, sizeof(*pR));
+   pR->pP= pP;
+   pR->pS= pS;
+} // lxRetryBegin
+
+Bool32 lxRetryAgain (LXRetry *pR, const int err)
+{
+   const int c= lxRetryClass(err);
+   RawTimeStamp t;
+   U64 ns;
+
+   timeStamp(&t);
+   if (0 == pR->nTry)
+   {
+      pR->tFail= t;
+      pR->seed= t.tv_nsec;
+   }
+   if (pR->pS) { pR->pS->nErr[c]++; }
+   if (pR->nTryC[c] >= pR->pP->maxTry[c]) { return(FALSE); }
+   if ((pR->pP->maxTotal > 0) && (pR->nTry >= pR->pP->maxTotal)) { return(FALSE); }
+   ns= backoffNS(pR);
+   if ((pR->pP->budgetNS > 0) && ((timeDiffNS(&(pR->tFail), &t) + (I64)ns) > pR->pP->budgetNS)) { return(FALSE); }
+   if (ns > 0) { sleepNS(ns); }
+   pR->nTry++;
+   pR->nTryC[c]++;
+   if (pR->pS) { pR->pS->nRetry++; }
+   return(TRUE);
+} // lxRetryAgain
+
+int lxRetryEnd (LXRetry *pR, const int r)
+{
+   LXRetryStat *pS= pR->pS;
+   if (pS)
+   {
+      pS->nCall++;
+      if (r < 0) { pS->nFail++; }
+      if ((pR->nTry > 0) || (r < 0))
+      {
+         RawTimeStamp t;
+         I64 ns= 0;
+         if (0 != pR->tFail.tv_sec) { timeStamp(&t); ns= timeDiffNS(&(pR->tFail), &t); }
+         pS->nRetried+= (pR->nTry > 0);
+         pS->sumNS+= ns;
+         if (ns > pS->maxNS) { pS->maxNS= ns; }
+      }
+   }
+   return(r);
+} // lxRetryEnd
+
+void lxRetryDump (const char *name, const LXRetryStat *pS, const U8 reportID)
+{
+   report(reportID, "%s: %u ops, %u retried (%u retries), %u failed, errors AGAIN:%u NAK:%u TIMEOUT:%u OTHER:%u, retry time %.3fms (max %.3fms)\n",
+      name, pS->nCall, pS->nRetried, pS->nRetry, pS->nFail,
+      pS->nErr[LX_RETRY_AGAIN], pS->nErr[LX_RETRY_NAK], pS->nErr[LX_RETRY_TIMEOUT], pS->nErr[LX_RETRY_OTHER],
+      1E-6 * pS->sumNS, 1E-6 * pS->maxNS);
+} // lxRetryDump
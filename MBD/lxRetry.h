@@ -0,0 +1,85 @@
+// Common/MBD/lxRetry.h - retry & backoff policy with latency accounting for bus transactions
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#ifndef LX_RETRY_H
+#define LX_RETRY_H
+
+#include "lxTiming.h"
+
+
+/***/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Error classes
+enum LXRetryClass
+{
+   LX_RETRY_AGAIN,   // EAGAIN, EBUSY, EINTR or soft failure (e.g. data not ready, verify mismatch)
+   LX_RETRY_NAK,     // EREMOTEIO, ENXIO (device busy/absent)
+   LX_RETRY_TIMEOUT, // ETIMEDOUT (bus stalled)
+   LX_RETRY_OTHER,
+   LX_RETRY_NCLASS
+};
+
+// Backoff modes
+#define LX_RETRY_FIXED  (0)   // base each time
+#define LX_RETRY_EXP    (1)   // base * 2^i, capped at max
+#define LX_RETRY_JITTER (2)   // EXP scaled by random factor in [0.5,1) (decorrelates contending clients)
+
+typedef struct
+{
+   U32   baseNS, maxNS; // Backoff: first & limit (base 0 -> immediate retry)
+   U32   budgetNS;      // Total time from first failure after which no retry (0 -> none)
+   U8    maxTry[LX_RETRY_NCLASS];  // Retries permitted per error class (0 -> fail immediately)
+   U8    mode;
+   U8    maxTotal;      // Retries permitted over all classes (0 -> per class limits only)
+} LXRetryPolicy;
+
+typedef struct
+{
+   U32   nCall;      // Operations completed
+   U32   nRetried;   // Operations needing at least one retry
+   U32   nRetry;     // Retries issued
+   U32   nFail;      // Operations abandoned
+   U32   nErr[LX_RETRY_NCLASS];
+   U64   sumNS;      // Wall time from first failure to completion (backoff & repeated attempts)
+   U32   maxNS;
+} LXRetryStat;
+
+// Per operation state
+typedef struct
+{
+   const LXRetryPolicy *pP;
+   LXRetryStat *pS;  // Optional
+   RawTimeStamp tFail;
+   U32   seed;
+   U8    nTry, nTryC[LX_RETRY_NCLASS];
+} LXRetry;
+
+
+/***/
+
+// Classify errno value
+extern int lxRetryClass (const int err);
+
+extern void lxRetryBegin (LXRetry *pR, const LXRetryPolicy *pP, LXRetryStat *pS);
+
+// Following failure with errno value err (0 -> soft failure, class AGAIN): if policy
+// permits, sleep for backoff interval and return TRUE (caller should retry).
+extern Bool32 lxRetryAgain (LXRetry *pR, const int err);
+
+// Record outcome (r<0 -> abandoned) in statistics, returning r
+extern int lxRetryEnd (LXRetry *pR, const int r);
+
+// Report statistics
+extern void lxRetryDump (const char *name, const LXRetryStat *pS, const U8 reportID);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // LX_RETRY_H
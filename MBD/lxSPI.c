@@ -117,6 +117,29 @@ static void initTransProf (struct spi_ioc_transfer *pT, const SPIProfile *pP, U8
    pT->cs_change= contHoldCS; // continue transaction, hold CS asserted after transfer
 } // initTransProf
 
+static void initTransSeg (struct spi_ioc_transfer *pT, const LXSPISeg *pS, const SPIProfile *pP)
+{
+   initTransProf(pT, pP, pS->csChange);
+   pT->rx_buf= (UL)(pS->r);
+   pT->tx_buf= (UL)(pS->w);
+   pT->len=    pS->n;
+   if (pS->clk > 0) { pT->speed_hz= pS->clk; }
+   if (pS->delay > 0) { pT->delay_usecs= pS->delay; }
+   if (pS->bpw > 0) { pT->bits_per_word= pS->bpw; }
+} // initTransSeg
+
+static U32 getBufSz (void)
+{  // spidev module parameter (fixed at load), rx & tx each limited per message
+   FILE *hF= fopen("/sys/module/spidev/parameters/bufsiz", "r");
+   unsigned int b= 0;
+   if (hF)
+   {
+      if (1 != fscanf(hF, "%u", &b)) { b= 0; }
+      fclose(hF);
+   }
+   return((b > 0) ? b : LX_SPI_BUF_DEF);
+} // getBufSz
+
 /***/
 
 Bool32 lxSPIOpen (LXSPICtx *pSC, const char devPath[], const SPIProfile *pP)
@@ -129,6 +152,7 @@ Bool32 lxSPIOpen (LXSPICtx *pSC, const char devPath[], const SPIProfile *pP)
       if (pSC->fd >= 0)
       {
          r= ioctl(pSC->fd, SPI_IOC_RD_MAX_SPEED_HZ, &(pSC->maxClk));
+         pSC->bufSz= getBufSz();
          if (pP)
          {
             r= setProf(pSC->fd, pP);
@@ -175,10 +199,44 @@ int lxSPIReadWrite (LXSPICtx *pSC, U8 r[], const U8 w[], int n)
    return ioctl(pSC->fd, SPI_IOC_MESSAGE(1), &m);
 } // lxSPIReadWrite
 
+int lxSPITransfer (LXSPICtx *pSC, const LXSPISeg s[], const int nS)
+{
+   struct spi_ioc_transfer m[LX_SPI_MSG_MAX];
+   const U32 bufSz= (pSC->bufSz > 0) ? pSC->bufSz : LX_SPI_BUF_DEF;
+   int i= 0, t= 0;
+
+   while (i < nS)
+   {
+      U32 nR= 0, nW= 0;
+      int j, k= 0, r;
+
+      for (j= 0; (j < (int)LX_SPI_MSG_MAX) && ((i+j) < nS); j++)
+      {
+         const LXSPISeg *pS= s+i+j;
+         if (pS->r) { nR+= pS->n; }
+         if (pS->w) { nW+= pS->n; }
+         if ((nR > bufSz) || (nW > bufSz)) { break; }
+         initTransSeg(m+j, pS, &(pSC->currProf));
+         if (pS->csChange) { k= j+1; }
+      }
+      if (j <= 0) { ERROR_CALL("(.. [%d]) - segment exceeds %u bytes\n", i, bufSz); return(-1); }
+      if (((i+j) < nS) && (k > 0)) { j= k; } // avoid releasing CS within a held sequence
+      m[j-1].cs_change= 0; // (on last transfer would hold CS after message)
+      r= ioctl(pSC->fd, SPI_IOC_MESSAGE(j), m);
+      if (r < 0) { ERROR_CALL("(.. [%d+%d]) - %d\n", i, j, errno); return(r); }
+      t+= r;
+      i+= j;
+   }
+   return(t);
+} // lxSPITransfer
+
 #ifdef LX_SPI_MAIN
 
+#include "ad9833.h"
+
 #define ARG_ACTION 0xF0  // Mask
 #define ARG_HACK   (1<<4)
+#define ARG_SWEEP  (1<<5)
 
 #define ARG_OPTION   0x0F  // Mask
 #define ARG_HELP    (1<<1)
@@ -195,11 +253,12 @@ static LXSPICtx gBusCtx;
 
 void usageMsg (const char name[])
 {
-static const char optCh[]="dvh";
-static const char argCh[]="#  ";
+static const char optCh[]="dsvh";
+static const char argCh[]="#   ";
 static const char *desc[]=
 {
    "device index (-> path /dev/spidev0.# )",
+   "AD9833 frequency sweep (batched register writes)",
    "verbose diagnostic messages",
    "help (display this text)",
 };
@@ -222,7 +281,7 @@ void argTrans (LXSPIArgs *pA, int argc, char *argv[])
    int c;
    do
    {
-      c= getopt(argc,argv,"d:vh");
+      c= getopt(argc,argv,"d:svh");
       switch(c)
       {
          case 'd' :
@@ -231,6 +290,9 @@ void argTrans (LXSPIArgs *pA, int argc, char *argv[])
             if ((ch > '0') && (ch <= '9')) { pA->devPath[13]= ch; }
             break;
          }
+         case 's' :
+            pA->flags|= ARG_SWEEP;
+            break;
          case 'h' :
             pA->flags|= ARG_HELP;
             break;
@@ -243,6 +305,38 @@ void argTrans (LXSPIArgs *pA, int argc, char *argv[])
    if (pA->flags & ARG_VERBOSE) { argDump(pA); }
 } // argTrans
 
+#define SWEEP_STEPS (250)
+
+static void setWordBE (U8 b[2], const U16 w) { b[0]= w >> 8; b[1]= w; }
+
+// AD9833 FREQ0 sweep 1..25kHz (25MHz MCLK): each 16b word latched by FSYNC (CS) release,
+// so B28 control word then lo,hi word pair per step, all submitted as one segment list.
+static int sweepAD9833 (LXSPICtx *pSC)
+{
+   static U8 wb[2*(1+2*SWEEP_STEPS)];
+   static LXSPISeg seg[1+2*SWEEP_STEPS];
+   int i, n= 0;
+
+   setWordBE(wb, AD9833_FL1_B28 << 8);
+   for (i= 0; i<SWEEP_STEPS; i++)
+   {
+      const U32 ftw= ((U64)(i+1) * 100 << 28) / 25000000; // 100Hz steps
+      setWordBE(wb + 2 + 4*i, (AD9833_REG_FREQ0 << 14) | (ftw & AD9833_FSR_MASK));
+      setWordBE(wb + 4 + 4*i, (AD9833_REG_FREQ0 << 14) | ((ftw >> 14) & AD9833_FSR_MASK));
+   }
+   memset(seg, 0, sizeof(seg));
+   for (i= 0; i<(1+2*SWEEP_STEPS); i++)
+   {
+      seg[i].w= wb + 2*i;
+      seg[i].n= 2;
+      seg[i].csChange= 1;
+      n+= seg[i].n;
+   }
+   i= lxSPITransfer(pSC, seg, 1+2*SWEEP_STEPS);
+   LOG("lxSPITransfer() - %d/%d bytes, %d segments (<=%d per message, bufsiz=%u)\n", i, n, 1+2*SWEEP_STEPS, (int)LX_SPI_MSG_MAX, pSC->bufSz);
+   return(i);
+} // sweepAD9833
+
 int main (int argc, char *argv[])
 {
    SPIProfile prof;
@@ -261,6 +355,7 @@ int main (int argc, char *argv[])
       r= lxSPIReadWrite(&gBusCtx,rd,wr,3);
       LOG("lxSPIReadWrite() - %d : ", r);
       reportBytes(DBG, rd, r);
+      if (gArgs.flags & ARG_SWEEP) { r= sweepAD9833(&gBusCtx); }
       lxSPIClose(&gBusCtx);
    }
    return(r);
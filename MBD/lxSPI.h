@@ -16,6 +16,10 @@
 extern "C" {
 #endif
 
+// Transfers per SPI_IOC_MESSAGE(n): ioctl size field (_IOC_SIZEBITS=14) / sizeof(struct spi_ioc_transfer)
+#define LX_SPI_MSG_MAX  (((1<<_IOC_SIZEBITS)-1) / sizeof(struct spi_ioc_transfer))
+#define LX_SPI_BUF_DEF  (4096)  // spidev module default bufsiz: bytes per message per direction
+
 typedef struct
 {  // NB : SPI_CS_HIGH = idle LO -> active HI
    U32 kdmf, clk;    // kernel driver mode flags, transaction clock rate
@@ -28,9 +32,20 @@ typedef struct
 {
    int  fd;
    U32   maxClk;
+   U32   bufSz;     // spidev per message byte limit (each of tx & rx)
    SPIProfile currProf;
 } LXSPICtx; // Consider change to *Bus* Ctx ???
 
+typedef struct
+{  // Segment of batched transfer: zero clk, delay or bpw -> use context profile
+   U8       *r;         // receive buffer (NULL -> discard)
+   const U8 *w;         // transmit buffer (NULL -> receive only)
+   U32      n;          // bytes
+   U32      clk;
+   U16      delay;      // microseconds after segment
+   U8       csChange;   // release chip select after segment (e.g. AD9833 FSYNC latches each word)
+   U8       bpw;
+} LXSPISeg;
 
 
 /***/
@@ -39,6 +54,11 @@ extern Bool32 lxSPIOpen (LXSPICtx *pSC, const char devPath[], const SPIProfile *
 
 extern int lxSPIReadWrite (LXSPICtx *pSC, U8 r[], const U8 w[], int n);
 
+// Submit segment list as few SPI_IOC_MESSAGE(n) calls as spidev limits permit, splitting
+// preferably after a segment that releases chip select. Chip select is always released at
+// the end of the list. Returns total bytes transferred (<0 on error).
+extern int lxSPITransfer (LXSPICtx *pSC, const LXSPISeg s[], const int nS);
+
 extern void lxSPIClose (LXSPICtx *pSC);
 
 #ifdef __cplusplus
@@ -43,6 +43,24 @@ F32 timeDiff (const RawTimeStamp *pR, const RawTimeStamp *pT)
    return DNSECF(*pR, *pT);
 } // timeNow
 
+I64 timeDiffNS (const RawTimeStamp *pR, const RawTimeStamp *pT)
+{
+   return((I64)(pT->tv_sec - pR->tv_sec) * NANO_TICKS + (pT->tv_nsec - pR->tv_nsec));
+} // timeDiffNS
+
+I64 timeNS (const RawTimeStamp *pT) { return((I64)(pT->tv_sec) * NANO_TICKS + pT->tv_nsec); }
+
+void timeSetNS (RawTimeStamp *pT, const I64 ns)
+{
+   pT->tv_sec= ns / NANO_TICKS;
+   pT->tv_nsec= ns % NANO_TICKS;
+} // timeSetNS
+
+Bool32 timeBefore (const RawTimeStamp *pA, const RawTimeStamp *pB)
+{
+   return((pA->tv_sec < pB->tv_sec) || ((pA->tv_sec == pB->tv_sec) && (pA->tv_nsec < pB->tv_nsec)));
+} // timeBefore
+
 F32 timeEstDiff (const RawTimeStamp *pR, const RawTimeStamp *pT1, const RawTimeStamp *pT2, const F32 r[2])
 {
    F32 d[2];
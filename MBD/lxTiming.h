@@ -45,6 +45,15 @@ extern F32 timeElapsed (RawTimeStamp *pLast);
 // Simple time difference from reference: T - R seconds
 extern F32 timeDiff (const RawTimeStamp *pR, const RawTimeStamp *pT);
 
+// Nanosecond equivalents of the above: time difference T - R, and conversion to/from
+// an absolute count (epoch relative, I64 range sufficient for ~292 years)
+extern I64 timeDiffNS (const RawTimeStamp *pR, const RawTimeStamp *pT);
+extern I64 timeNS (const RawTimeStamp *pT);
+extern void timeSetNS (RawTimeStamp *pT, const I64 ns);
+
+// Ordering: TRUE if A strictly earlier than B
+extern Bool32 timeBefore (const RawTimeStamp *pA, const RawTimeStamp *pB);
+
 // Estimate time difference (in seconds) as a linear combination of two timestamps measure from some reference
 extern F32 timeEstDiff (const RawTimeStamp *pR, const RawTimeStamp *pT1, const RawTimeStamp *pT2, const F32 r[2]);
 
@@ -58,6 +67,7 @@ extern int timeSetTarget (RawTimeStamp *pTarget, RawTimeStamp *pBase, const long
 // Returns >=0 if successful
 extern int timeSpinWaitUntil (RawTimeStamp *pNow, const RawTimeStamp *pTarget);
 
+
 // Hybrid delay of up to 1 second implemented as sleep (for 2+ millisecond
 // delays) and spin-wait (using clock) to achieve improved time resolution
 // with a (limited) degree of efficiency.
@@ -0,0 +1,118 @@
+// firDecim.c - streaming FIR decimation of interleaved multi-channel sample data
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#include "firDecim.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// GCC/Clang generic vectors: mapped to AVX, SSE or NEON registers by the
+// compiler as available for the target, so one kernel serves all.
+typedef F32 VF32 __attribute__((vector_size(FIRD_VW * sizeof(F32))));
+
+
+/***/
+
+// Dot product of n (multiple of FIRD_VW) elements: h[] aligned, x[] unaligned
+static F32 dotV (const F32 *h, const F32 *x, const int n)
+{
+   VF32 s= {0}, a, b;
+   for (int i=0; i<n; i+= FIRD_VW)
+   {
+      memcpy(&a, h+i, sizeof(a));
+      memcpy(&b, x+i, sizeof(b)); // NB: compiles to unaligned load
+      s+= a * b;
+   }
+   F32 r= 0;
+   for (int i=0; i<FIRD_VW; i++) { r+= s[i]; }
+   return(r);
+} // dotV
+
+int firDecimInit (FIRDecim *pD, const int nChan, const int dec, const int nTaps, const F32 fc)
+{
+   F64 sum= 0;
+
+   memset(pD, 0, sizeof(*pD));
+   if ((nChan <= 0) || (nChan > FIRD_CHAN_MAX) || (dec <= 0) || (nTaps <= 0) || (nTaps > FIRD_TAPS_MAX))
+   {
+      ERROR_CALL("(.. %d, %d, %d ..) - invalid\n", nChan, dec, nTaps);
+      return(-1);
+   }
+   pD->nChan= nChan;
+   pD->dec= dec;
+   pD->nTaps= nTaps;
+   pD->nTapsV= (nTaps + FIRD_VW - 1) & ~(FIRD_VW - 1);
+
+   F32 *pH= pD->h + (pD->nTapsV - nTaps); // leading zero padding
+   const F64 wc= M_PI * fc / dec; // cutoff (radians per input sample)
+   const F64 m= 0.5 * (nTaps - 1);
+   for (int i=0; i<nTaps; i++)
+   {
+      const F64 x= i - m;
+      F64 w= 1, s= wc / M_PI;
+      if (nTaps > 1) { w= 0.42 - 0.5 * cos(2 * M_PI * i / (nTaps-1)) + 0.08 * cos(4 * M_PI * i / (nTaps-1)); }
+      if (0 != x) { s= sin(wc * x) / (M_PI * x); }
+      pH[i]= s * w;
+      sum+= pH[i];
+   }
+   if (0 != sum) { for (int i=0; i<nTaps; i++) { pH[i]/= sum; } }
+   return(nTaps);
+} // firDecimInit
+
+int firDecimProcess
+(
+   FIRDecim *pD,
+   F32 * const pY[],
+   F32 * const pTY[],
+   int nY[],
+   const int maxY,
+   const F32 x[],
+   const F32 tx[],
+   const U8 vx[],
+   const int nX
+)
+{
+   const int nV= pD->nTapsV, nC= pD->nChan;
+   // Filter centre relative to newest sample (linear phase group delay)
+   const int dLo= (pD->nTaps - 1) / 2, dHi= pD->nTaps / 2;
+   int n= 0;
+
+   for (int c=0; c<nC; c++)
+   {  // Each channel in turn over the whole block: stride through its samples
+      FIRDecimChan *pC= pD->c + c;
+      int i= (c + nC - pD->iChan) % nC; // first sample of this channel
+
+      while (i < nX)
+      {
+         do
+         {  // Fill history up to the next output (or end of block)
+            if ((NULL == vx) || vx[i]) { pC->xHold= x[i]; }
+            pC->x[pC->iW]= pC->x[pC->iW + nV]= pC->xHold;
+            if (tx) { pC->t[pC->iW]= pC->t[pC->iW + nV]= tx[i]; }
+            if (++(pC->iW) >= nV) { pC->iW= 0; }
+            i+= nC;
+         } while ((++(pC->phase) < pD->dec) && (i < nX));
+         // Window (oldest first) now at x[iW .. iW+nV-1], newest at iW+nV-1
+         if (pC->phase >= pD->dec)
+         {
+            pC->phase= 0;
+            if (nY[c] < maxY)
+            {
+               pY[c][nY[c]]= dotV(pD->h, pC->x + pC->iW, nV);
+               if (pTY)
+               {
+                  const int j= pC->iW + nV - 1;
+                  if (tx) { pTY[c][nY[c]]= 0.5 * (pC->t[j - dLo] + pC->t[j - dHi]); } else { pTY[c][nY[c]]= 0; }
+               }
+               nY[c]++;
+               n++;
+            }
+         }
+      }
+   }
+   pD->iChan= (pD->iChan + nX) % nC;
+   return(n);
+} // firDecimProcess
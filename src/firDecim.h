@@ -0,0 +1,70 @@
+// firDecim.h - streaming FIR decimation of interleaved multi-channel sample data
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#ifndef FIR_DECIM_H
+#define FIR_DECIM_H
+
+#include "util.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FIRD_VW         (8)   // Kernel vector width (F32 elements)
+#define FIRD_TAPS_MAX   (128) // multiple of FIRD_VW
+#define FIRD_CHAN_MAX   (8)
+
+typedef struct
+{
+   F32 x[2*FIRD_TAPS_MAX]; // Sample history, duplicated so that the window is always contiguous
+   F32 t[2*FIRD_TAPS_MAX]; // Timestamp history (as above)
+   F32 xHold;              // Last valid sample (substituted for invalid ones)
+   U16 iW, phase;
+} FIRDecimChan;
+
+typedef struct
+{
+   F32 h[FIRD_TAPS_MAX];   // Coefficients, zero padded (oldest end) to multiple of FIRD_VW
+   FIRDecimChan c[FIRD_CHAN_MAX];
+   U16 nTaps, nTapsV;      // actual & padded length
+   U16 dec;                // Decimation factor
+   U8  nChan, iChan;       // Channel count & next (interleave position)
+} FIRDecim;
+
+
+/***/
+
+// Design windowed-sinc (Blackman) low pass filter with cutoff at fraction fc of
+// the output Nyquist rate (i.e. 0.5 * fc / dec of input rate) and unity DC gain,
+// then reset channel state. Returns number of taps, or <=0 on error.
+extern int firDecimInit (FIRDecim *pD, const int nChan, const int dec, const int nTaps, const F32 fc);
+
+// Process nX interleaved samples x[] (with timestamps tx[]) starting at the
+// next expected channel. Samples flagged invalid (zero in optional vx[]) are
+// replaced by the channel's last valid sample, so dropouts do not disturb the
+// filter. Decimated output for channel c is appended to pY[c][], with
+// timestamps (input timestamps interpolated at filter centre, i.e.
+// compensating for group delay) to pTY[c][] if pTY is non-NULL.
+// nY[c] holds the count already present in channel c, which is updated: output
+// beyond maxY per channel is discarded. Returns the total count appended.
+extern int firDecimProcess
+(
+   FIRDecim *pD,
+   F32 * const pY[],
+   F32 * const pTY[],
+   int nY[],
+   const int maxY,
+   const F32 x[],
+   const F32 tx[],
+   const U8 vx[],
+   const int nX
+);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // FIR_DECIM_H
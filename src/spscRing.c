@@ -0,0 +1,94 @@
+// spscRing.c - lock-free single producer, single consumer ring buffer of fixed size records
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#include "spscRing.h"
+
+// GCC/Clang atomic builtins: release store publishes record content
+// written before the index update, acquire load guarantees visibility.
+#define SPSC_LOAD(p)    __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define SPSC_STORE(p,v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+
+/***/
+
+B32 spscInit (SPSCRing *pR, U32 nRec, U32 recBytes)
+{
+   void *p= NULL;
+   U32 n= 1;
+
+   memset(pR, 0, sizeof(*pR));
+   while ((n < nRec) && (n < (1U<<31))) { n<<= 1; }
+   if ((recBytes > 0) && (0 == posix_memalign(&p, SPSC_CACHE_LINE, (size_t)n * recBytes)))
+   {
+      pR->pB= p;
+      pR->mask= n-1;
+      pR->recBytes= recBytes;
+      return(TRUE);
+   }
+   ERROR_CALL("(.. %u, %u) - alloc fail\n", nRec, recBytes);
+   return(FALSE);
+} // spscInit
+
+void spscRelease (SPSCRing *pR)
+{
+   if (pR && pR->pB) { free(pR->pB); pR->pB= NULL; }
+} // spscRelease
+
+void *spscWritePtr (SPSCRing *pR)
+{
+   const U32 w= pR->w.idx;
+   if ((w - pR->w.cache) > pR->mask)
+   {  // Apparently full: refresh view of consumer
+      pR->w.cache= SPSC_LOAD(&(pR->r.idx));
+      if ((w - pR->w.cache) > pR->mask) { pR->w.nFail++; return(NULL); }
+   }
+   return(pR->pB + (size_t)(w & pR->mask) * pR->recBytes);
+} // spscWritePtr
+
+void spscWriteCommit (SPSCRing *pR) { SPSC_STORE(&(pR->w.idx), pR->w.idx+1); }
+
+B32 spscPush (SPSCRing *pR, const void *pRec)
+{
+   void *p= spscWritePtr(pR);
+   if (p)
+   {
+      memcpy(p, pRec, pR->recBytes);
+      spscWriteCommit(pR);
+   }
+   return(NULL != p);
+} // spscPush
+
+const void *spscReadPtr (SPSCRing *pR)
+{
+   const U32 r= pR->r.idx;
+   if (r == pR->r.cache)
+   {  // Apparently empty: refresh view of producer
+      pR->r.cache= SPSC_LOAD(&(pR->w.idx));
+      if (r == pR->r.cache) { pR->r.nFail++; return(NULL); }
+   }
+   return(pR->pB + (size_t)(r & pR->mask) * pR->recBytes);
+} // spscReadPtr
+
+void spscReadRelease (SPSCRing *pR) { SPSC_STORE(&(pR->r.idx), pR->r.idx+1); }
+
+int spscPop (SPSCRing *pR, void *pRec, const int max)
+{
+   U8 *pB= pRec;
+   int n= 0;
+   const void *p;
+   while ((n < max) && (p= spscReadPtr(pR)))
+   {
+      memcpy(pB, p, pR->recBytes);
+      spscReadRelease(pR);
+      pB+= pR->recBytes;
+      n++;
+   }
+   return(n);
+} // spscPop
+
+U32 spscCount (const SPSCRing *pR)
+{
+   return(SPSC_LOAD(&(pR->w.idx)) - SPSC_LOAD(&(pR->r.idx)));
+} // spscCount
@@ -0,0 +1,61 @@
+// spscRing.h - lock-free single producer, single consumer ring buffer of fixed size records
+// https://github.com/DrAl-HFS/Common.git
+// Licence: GPL V3
+// (c) Project Contributors Sept 2021
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include "util.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Producer and consumer state are kept on separate cache lines to
+// prevent "false sharing" between the two threads.
+#ifndef SPSC_CACHE_LINE
+#define SPSC_CACHE_LINE (64)
+#endif
+
+typedef struct
+{
+   U32 idx;    // Free running position (owner writes, other party reads)
+   U32 cache;  // Last observed position of other party (owner private)
+   U32 nFail;  // Push overruns (producer) or empty pops (consumer)
+} __attribute__((aligned(SPSC_CACHE_LINE))) SPSCIdx;
+
+typedef struct
+{
+   SPSCIdx  w, r; // Producer (write) and consumer (read) state
+   U8       *pB;  // Record storage
+   U32      mask; // Record count - 1 (count is power of two)
+   U32      recBytes;
+} SPSCRing; // NB: static or stack instance required for guaranteed alignment
+
+
+/***/
+
+// Allocate storage for at least nRec records (rounded up to power of two)
+extern B32 spscInit (SPSCRing *pR, U32 nRec, U32 recBytes);
+extern void spscRelease (SPSCRing *pR);
+
+// Producer side: zero-copy slot access (NULL if full) & commit, or copying push
+extern void *spscWritePtr (SPSCRing *pR);
+extern void spscWriteCommit (SPSCRing *pR);
+extern B32 spscPush (SPSCRing *pR, const void *pRec);
+
+// Consumer side: zero-copy access (NULL if empty) & release, or copying pop of up to max records
+extern const void *spscReadPtr (SPSCRing *pR);
+extern void spscReadRelease (SPSCRing *pR);
+extern int spscPop (SPSCRing *pR, void *pRec, const int max);
+
+// Approximate count of records held (exact only when other party idle)
+extern U32 spscCount (const SPSCRing *pR);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // SPSC_RING_H